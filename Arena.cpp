@@ -1,154 +1,267 @@
 #include "Arena.h"
 #include "RobotBase.h"
-#include <cstdlib>
 #include "RadarObj.h"
-#include <cmath>
-Arena::Arena(int height, int width, std::map<std::string, RobotBase*> robots, int num_of_obstacles):
+#include <cstdlib>
+#include "LineTrace.h"
+#include "ThreadPool.h"
+#include "RobotRunner.h"
+#include "ReplayLog.h"
+#include "ArenaSnapshot.h"
+#include <iterator>
+#include <charconv>
+#include <algorithm>
+#include <stdexcept>
+Arena::Arena(int height, int width, std::map<std::string, RobotBase*> robots, int num_of_obstacles, std::uint64_t seed,
+	int num_pits, int num_mounds, int num_flames):
 	mHeight(height),
 	mWidth(width),
-	mRobots(robots),
+	mRobotIdWidth(2),
 	mObstacles(num_of_obstacles),
-	mAlive(static_cast<int>(robots.size())){
-		mGrid.resize(height, std::vector<std::string>(width, "."));
+	mPits(num_pits),
+	mMounds(num_mounds),
+	mFlames(num_flames),
+	mAlive(0),
+	mAliveIndexSum(0),
+	mRng(seed),
+	mSimultaneousRadar(false),
+	mRadarPool(nullptr),
+	mSeed(seed),
+	mRound(0){
+		mCells.assign(static_cast<size_t>(height) * width, Cell{'.', '.', -1});
+		mOccupied.reset(height, width);
+		// the map's order fixes each robot's dense index
+		mRobots.reserve(robots.size());
+		mRobotIds.reserve(robots.size());
+		for(auto& [id, robot] : robots){
+			mRobots.push_back(robot);
+			mRobotIds.push_back(id);
+			mRobotIdWidth = std::max(mRobotIdWidth, static_cast<int>(id.size()));
+			if(robot && robot->get_health()>0){
+				mAlive++;
+				mAliveIndexSum+=static_cast<long long>(mRobots.size()-1);
+			};
+		};
 		placeItems();
 };
+Arena::Arena(const Arena& source, ForkTag):
+	mCells(source.mCells),
+	mOccupied(source.mOccupied),
+	mHeight(source.mHeight),
+	mWidth(source.mWidth),
+	mRobotIds(source.mRobotIds),
+	mRobotIdWidth(source.mRobotIdWidth),
+	mObstacles(source.mObstacles),
+	mPits(source.mPits),
+	mMounds(source.mMounds),
+	mFlames(source.mFlames),
+	mAlive(source.mAlive),
+	mAliveIndexSum(source.mAliveIndexSum),
+	mDeaths(source.mDeaths),
+	mRng(source.mRng),
+	mSimultaneousRadar(source.mSimultaneousRadar),
+	mRadarPool(nullptr),
+	mSeed(source.mSeed),
+	mRound(source.mRound){
+		for(RobotBase* robot : source.mRobots){
+			mStandIns.push_back(std::make_unique<RobotStandIn>(*robot));
+			mRobots.push_back(mStandIns.back().get());
+		};
+};
+Arena::~Arena(){
+	// runner threads stop before the robots can go away
+	mRunners.clear();
+	if(mReplay){
+		mReplay->close(mRound);
+	};
+};
+void Arena::setCell(int row, int col, Cell cell){
+	Cell& current = cellAt(row,col);
+	bool wasOccupied = current.type != '.';
+	bool occupied = cell.type != '.';
+	current = cell;
+	if(wasOccupied != occupied){
+		mOccupied.set(row, col, occupied);
+	};
+	if(mReplay){
+		mReplay->event(ReplayCell, cell.type, cell.robot, row, col);
+	};
+};
+void Arena::setOccupant(int row, int col, char type, int robot){
+	setCell(row, col, Cell{type, cellAt(row, col).terrain, robot});
+};
+void Arena::clearOccupant(int row, int col){
+	char terrain = cellAt(row, col).terrain;
+	setCell(row, col, Cell{terrain, terrain, -1});
+};
 void Arena::placeItems(){
-	std::vector<std::string> itemtypes={"P", "M", "F"};
-	for(int i=0;i<mObstacles;i++){
-		int row=rand() % (mHeight-2) +1;
-		int col=rand() % (mWidth-2) +1;
-		while(mGrid[row][col]!="."){
-			row=rand() % (mHeight-2) +1;
-                	col=rand() % (mWidth-2) +1;
-		}
-		int type=rand() % 3;
-		mGrid[row][col]=itemtypes[type];
-		
-	}; 
-	for(auto& [id, robot] : mRobots){
-		int row=rand() % mHeight;
-                int col=rand() % mWidth;
-		while(mGrid[row][col]!="."){
-			row=rand() % mHeight;
-                        col=rand() % mWidth;
-		}
-		mGrid[row][col]=id;
+	const char itemtypes[]={'P', 'M', 'F'};
+	// mObstacles of random type, then the exact per-type counts
+	const int counts[]={mObstacles, mPits, mMounds, mFlames};
+
+	// Partial Fisher-Yates: each pick swaps a random untaken cell to the
+	// front, so every placement is one draw however full the board is.
+	auto pick=[this](std::vector<int>& cells, size_t& taken){
+		size_t chosen=taken+mRng.below(static_cast<int>(cells.size()-taken));
+		std::swap(cells[taken],cells[chosen]);
+		return cells[taken++];
+	};
+
+	// ---- OBSTACLES: FREE INTERIOR CELLS ----
+	std::vector<int> freeCells;
+	for(int row=1;row<mHeight-1;row++){
+		for(int col=1;col<mWidth-1;col++){
+			if(cellAt(row,col).type=='.'){
+				freeCells.push_back(row*mWidth+col);
+			};
+		};
+	};
+	long long obstacles=0;
+	for(int count : counts){
+		obstacles+=count;
+	};
+	if(obstacles>static_cast<long long>(freeCells.size())){
+		throw std::runtime_error("cannot place "+std::to_string(obstacles)+" obstacles, only "+
+			std::to_string(freeCells.size())+" free cells inside the border");
+	};
+	size_t taken=0;
+	for(int kind=0;kind<4;kind++){
+		for(int i=0;i<counts[kind];i++){
+			int cell=pick(freeCells,taken);
+			int type=(kind==0) ? mRng.below(3) : kind-1;
+			setCell(cell/mWidth,cell%mWidth,Cell{itemtypes[type], itemtypes[type], -1});
+		};
+	};
+
+	// ---- ROBOTS: ANY FREE CELL ----
+	freeCells.clear();
+	for(int cell=0;cell<mHeight*mWidth;cell++){
+		if(mCells[cell].type=='.'){
+			freeCells.push_back(cell);
+		};
+	};
+	if(mRobots.size()>freeCells.size()){
+		throw std::runtime_error("cannot place "+std::to_string(mRobots.size())+" robots, only "+
+			std::to_string(freeCells.size())+" free cells left");
+	};
+	taken=0;
+	for(int index=0;index<static_cast<int>(mRobots.size());index++){
+		RobotBase* robot=mRobots[index];
+		int cell=pick(freeCells,taken);
+		int row=cell/mWidth;
+		int col=cell%mWidth;
+		setOccupant(row,col,'R',index);
 		robot->move_to(row,col);
 		robot->set_boundaries(mHeight,mWidth);
 	};
 };
-int Arena::getAlive(){
-	int result=0;
-	for(auto& [name,robot] : mRobots){
-		int health=robot->get_health();
-		if(health>0){
-			result+=1;
-		};
+std::string Arena::getWinner() const{
+	if(mAlive!=1){
+		return "none";
 	};
-	mAlive=result;
-	return mAlive;
+	return mRobotIds[static_cast<size_t>(mAliveIndexSum)];
 };
-std::string Arena::getWinner(){
-	if(mAlive>1 || mAlive==0){
-		return "none";
+bool Arena::damageRobot(int index, int damage){
+	RobotBase* robot = mRobots[index];
+	// the dead take no more damage and cannot die twice
+	if(robot->get_health()<=0){
+		return false;
 	};
-	std::string result;
-	for(auto& [name,robot] : mRobots){
-		int health = robot->get_health();
-		if(health>0){
-			result= name;
-		};
+	robot->take_damage(damage);
+	if(mReplay){
+		mReplay->event(ReplayDamage, 0, index, damage, robot->get_health());
 	};
-	return result;
+	if(robot->get_health()>0){
+		return false;
+	};
+	robot->disable_movement();
+	robotDied(index);
+	return true;
+};
+void Arena::robotDied(int index){
+	mAlive--;
+	mAliveIndexSum-=index;
+	mDeaths.push_back(index);
 };
 void Arena::printState(std::ostream& os){
+	// The whole board is built in mPrintBuffer (capacity kept between
+	// calls) and handed to the stream in one write.
+	std::string& out = mPrintBuffer;
+	out.clear();
+	char number[16];
+
 	// ---- PRINT TOP COLUMN NUMBERS ----
-    os << "    ";   // space for row numbers on the left
+    out += "    ";   // space for row numbers on the left
 
     for (int col = 0; col < mWidth; col++) {
-        os << col << "  ";
+        char* end = std::to_chars(number, number + sizeof(number), col).ptr;
+        out.append(number, end);
+        // wider tokens ("R@1") widen the cells, so keep the numbers over them
+        if (mRobotIdWidth > 2)
+            out.append(std::max<int>(1, mRobotIdWidth + 1 - static_cast<int>(end - number)), ' ');
+        else
+            out += "  ";
     }
-    os << "\n";
+    out += "\n";
 
     // ---- PRINT EACH ROW WITH ROW NUMBER ----
     for (int row = 0; row < mHeight; row++) {
 
         // Print the row number on the left
-        os << row << "  ";
+        out.append(number, std::to_chars(number, number + sizeof(number), row).ptr);
+        out += "  ";
 
         // Print the actual arena row
         for (int col = 0; col < mWidth; col++) {
-		if(mGrid[row][col][0]=='R' || mGrid[row][col][0]=='X'){
-			os<<mGrid[row][col]<< " ";
+		const Cell& cell = cellAt(row,col);
+		// cells are padded to the longest token ("R@" -> 3 wide)
+		if(cell.type=='R' || cell.type=='X'){
+			const std::string& id = mRobotIds[cell.robot];
+			out += cell.type;
+			out.append(id, 1, std::string::npos);
+			out.append(mRobotIdWidth + 1 - id.size(), ' ');
 		}else{
-            		os << mGrid[row][col] << "  ";
+            		out += cell.type;
+            		out.append(mRobotIdWidth, ' ');
 		};
         }
 
-        os << "\n";
+        out += "\n";
     }
-	
+
+	os.write(out.data(), static_cast<std::streamsize>(out.size()));
 };
 std::vector<std::pair<int, int>> Arena::grenadeRadius(int x, int y){
 	std::vector<std::pair<int, int>> coords;
-	for(int dx = -1; dx <= 1; dx++){
-        	for(int dy = -1; dy <= 1; dy++){
-
-            		int nx = x + dx;
-            		int ny = y + dy;
-
-            // ✅ BOUNDS CHECK (critical)
-            		if(nx >= 0 && nx < mHeight &&
-               			ny >= 0 && ny < mWidth)
-            		{
-                		coords.push_back({nx, ny});
-            		}
-        	}
-    	}
+	for(const Offset& o : kGrenadeFootprint){
+		int nx = x + o.dr;
+		int ny = y + o.dc;
+
+		if(nx >= 0 && nx < mHeight && ny >= 0 && ny < mWidth){
+			coords.push_back({nx, ny});
+		}
+	}
 	return coords;
 };
 std::vector<std::pair<int, int>> Arena::flamePath(int sx, int sy, int tx, int ty){
 	std::vector<std::pair<int,int>> coords;
 
-    // ---- TRUE DIRECTION VECTOR ----
-    double dx = tx - sx;
-    double dy = ty - sy;
-
-    double length = std::sqrt(dx*dx + dy*dy);
+    const Offset* cells = flameFootprint(tx - sx, ty - sy);
 
     // No direction = no flame
-    if(length == 0.0)
+    if (!cells)
         return coords;
 
-    // ---- NORMALIZED FORWARD DIRECTION ----
-    double dirX = dx / length;
-    double dirY = dy / length;
-
-    // ---- PERPENDICULAR DIRECTION FOR WIDTH ----
-    double perpX = -dirY;
-    double perpY =  dirX;
-
-    // ---- STEP 4 UNITS FORWARD ----
-    for(int step = 1; step <= 4; step++)
+    // ---- 4 CELLS FORWARD, 3 WIDE ----
+    for (int i = 0; i < kFlameCells; i++)
     {
-        double centerX = sx + dirX * step;
-        double centerY = sy + dirY * step;
+        int gridX = sx + cells[i].dr;
+        int gridY = sy + cells[i].dc;
 
-        // ---- 3-WIDE STRIP ----
-        for(int w = -1; w <= 1; w++)
+        // ---- BOUNDS CHECK ----
+        if (gridX >= 0 && gridX < mHeight &&
+            gridY >= 0 && gridY < mWidth)
         {
-            double fx = centerX + perpX * w;
-            double fy = centerY + perpY * w;
-
-            int gridX = static_cast<int>(std::round(fx));
-            int gridY = static_cast<int>(std::round(fy));
-
-            // ---- BOUNDS CHECK ----
-            if(gridX >= 0 && gridX < mHeight &&
-               gridY >= 0 && gridY < mWidth)
-            {
-                coords.push_back({gridX, gridY});
-            }
+            coords.push_back({gridX, gridY});
         }
     }
 
@@ -157,63 +270,41 @@ std::vector<std::pair<int, int>> Arena::flamePath(int sx, int sy, int tx, int ty
 std::vector<std::pair<int, int>> Arena::railgunPath(int sx, int sy, int tx, int ty){
 	std::vector<std::pair<int,int>> coords;
 
-    double dx = tx - sx;
-    double dy = ty - sy;
-
-    double length = std::sqrt(dx*dx + dy*dy);
+    LineTrace trace(tx - sx, ty - sy);
 
     // No direction = no shot
-    if (length == 0.0)
+    if (trace.empty())
         return coords;
 
-    // ---- NORMALIZED DIRECTION ----
-    double dirX = dx / length;
-    double dirY = dy / length;
-
-    // ---- CURRENT FLOAT POSITION ----
-    double x = sx;
-    double y = sy;
-
-    // ---- STEP SIZE (small enough to not skip tiles) ----
-    double stepSize = 0.25;
-
-    // ---- MARCH UNTIL WE EXIT THE ARENA ----
-    while (true)
+    // ---- STEP UNTIL WE EXIT THE ARENA ----
+    for (int step = 1; ; step++)
     {
-        x += dirX * stepSize;
-        y += dirY * stepSize;
-
-        int gridX = static_cast<int>(std::round(x));
-        int gridY = static_cast<int>(std::round(y));
+        int gridX = sx + trace.rowOffset(step);
+        int gridY = sy + trace.colOffset(step);
 
-        // ---- STOP AT BOUNDARY ----
         if (gridX < 0 || gridX >= mHeight ||
             gridY < 0 || gridY >= mWidth)
         {
             break;
         }
 
-        // ---- PREVENT DUPLICATE INSERTS ----
-        if (coords.empty() || coords.back() != std::make_pair(gridX, gridY))
-        {
-            coords.push_back({gridX, gridY});
-        }
+        coords.push_back({gridX, gridY});
     }
 
     return coords;
 };
-void Arena::handle_movement(const std::string& name,
+void Arena::handle_movement(int index,
                             RobotBase* robot,
                             int direction,
                             int distance)
 {
-	static std::map<std::string, bool> robotOnFlame;
     int r, c;
     robot->get_current_location(r, c);
 
     int dr = directions[direction].first;
     int dc = directions[direction].second;
-	if(robot->get_move_speed()<=0){
+	// the dead stay where they fell, even if a fork is told to move them
+	if(robot->get_health()<=0 || robot->get_move_speed()<=0){
 		return;
 	};
     for (int step = 0; step < distance; ++step)
@@ -225,21 +316,21 @@ void Arena::handle_movement(const std::string& name,
         if (nr < 0 || nr >= mHeight || nc < 0 || nc >= mWidth)
             return;
 
-        std::string& cell = mGrid[nr][nc];
+        Cell& cell = cellAt(nr, nc);
 
         // ---- MOUND: BLOCK ONLY ----
-        if (cell == "M")
+        if (cell.type == 'M')
             return;
 
         // ---- PIT: ENTER + DISABLE FOREVER ----
-        if (cell == "P")
+        if (cell.type == 'P')
         {
             // Clear old position
-            mGrid[r][c] = ".";
+            clearOccupant(r, c);
 
-            // Mark robot as dead/trapped visually (X + symbol)
+            // The robot stands in the pit; the 'P' stays underneath
 
-            mGrid[nr][nc] = name;
+            setOccupant(nr, nc, 'R', index);
 
             robot->move_to(nr, nc);
             robot->disable_movement();
@@ -247,38 +338,30 @@ void Arena::handle_movement(const std::string& name,
         }
 
         // ---- FLAMETHROWER: DAMAGE BUT DO NOT REMOVE ----
-	bool steppingOnFlame = false;   // ✅ NEW
-
-	if (cell == "F")
+	if (cell.type == 'F')
 	{
-    		int dmg = 30 + rand() % 21;
-    		robot->take_damage(dmg);
-    		steppingOnFlame = true; 
-	    	if (robot->get_health() <= 0)
+    		int dmg = mRng.range(30, 50);
+	    	if (damageRobot(index, dmg))
 		{
-    			// Mark dead robot immediately on the grid
-    			std::string deadID = "X";
-    			deadID += name[1];   // preserve symbol
-
-    			mGrid[nr][nc] = deadID;
+    			// The robot dies where it stepped: "X" + the robot's
+    			// symbol on the flame, nothing left behind
+    			clearOccupant(r, c);
+    			setOccupant(nr, nc, 'X', index);
+    			robot->move_to(nr, nc);
 
     			return;  // Stop movement immediately
 		}
 	}
         // ---- ROBOT COLLISION: BLOCK ----
-        if (!cell.empty() && (cell[0] == 'R' || cell[0] == 'X'))
+        if (cell.type == 'R' || cell.type == 'X')
             return;
 
         // ---- APPLY MOVE ----
-	if (robotOnFlame[name]){
-    		mGrid[r][c] = "F";
-	}else{
-    		mGrid[r][c] = ".";
-	};
+        // The old cell shows its terrain again (an 'F' stays an 'F').
         // Even if cell == "F", we visually place the robot there,
-        // but the flame logically still exists under it.
-        mGrid[nr][nc] = name;
-	robotOnFlame[name] = steppingOnFlame;
+        // but the flame still exists under it in the terrain layer.
+        clearOccupant(r, c);
+        setOccupant(nr, nc, 'R', index);
 
         r = nr;
         c = nc;
@@ -291,29 +374,50 @@ void Arena::handle_shot(WeaponType weapon, RobotBase* robot, int shot_row, int s
     int sx, sy;
     robot->get_current_location(sx, sy);
 
-    std::vector<std::pair<int,int>> coords;
-
     switch (weapon)
     {
         case railgun:
         {
-            coords = railgunPath(sx, sy, shot_row, shot_col);
+            int dr = shot_row - sx;
+            int dc = shot_col - sy;
+
+            // Along a row, column or diagonal the path is a straight
+            // line of the board, so only its occupied cells are visited.
+            if ((dr != 0 || dc != 0) &&
+                (dr == 0 || dc == 0 || std::abs(dr) == std::abs(dc)))
+            {
+                int stepR = (dr > 0) - (dr < 0);
+                int stepC = (dc > 0) - (dc < 0);
+                mOccupied.forEachOnRay(sx, sy, stepR, stepC, 0,
+                                       [&](int r, int c) { applyDamageToCell(r, c, 10, 20); });
+                break;
+            }
 
-            for (auto& [r, c] : coords)
+            // Any other slope: same cells as railgunPath, without the list
+            LineTrace trace(dr, dc);
+
+            // No direction = no shot
+            if (trace.empty())
+                break;
+
+            for (int step = 1; ; step++)
             {
-                applyDamageToCell(r, c, 10, 20);
+                int r = sx + trace.rowOffset(step);
+                int c = sy + trace.colOffset(step);
+                if (r < 0 || r >= mHeight || c < 0 || c >= mWidth)
+                    break;
+
+                if (mOccupied.test(r, c))
+                    applyDamageToCell(r, c, 10, 20);
             }
             break;
         }
 
         case flamethrower:
         {
-            coords = flamePath(sx, sy, shot_row, shot_col);
-
-            for (auto& [r, c] : coords)
-            {
-                applyDamageToCell(r, c, 30, 50);
-            }
+            const Offset* cells = flameFootprint(shot_row - sx, shot_col - sy);
+            if (cells)
+                applyFootprint(sx, sy, cells, kFlameCells, 30, 50);
             break;
         }
 
@@ -325,12 +429,8 @@ void Arena::handle_shot(WeaponType weapon, RobotBase* robot, int shot_row, int s
 
             robot->decrement_grenades();
 
-            coords = grenadeRadius(shot_row, shot_col);
-
-            for (auto& [r, c] : coords)
-            {
-                applyDamageToCell(r, c, 10, 40);
-            }
+            applyFootprint(shot_row, shot_col, kGrenadeFootprint,
+                           static_cast<int>(std::size(kGrenadeFootprint)), 10, 40);
             break;
         }
 
@@ -344,33 +444,43 @@ void Arena::handle_shot(WeaponType weapon, RobotBase* robot, int shot_row, int s
             if (dr > 1 || dc > 1 || (dr == 0 && dc == 0))
                 return;
 
-            // Bounds check
-            if (shot_row < 0 || shot_row >= mHeight ||
-                shot_col < 0 || shot_col >= mWidth)
-                return;
-
-            applyDamageToCell(shot_row, shot_col, 50, 60);
+            applyFootprint(shot_row, shot_col, kHammerFootprint,
+                           static_cast<int>(std::size(kHammerFootprint)), 50, 60);
             break;
         }
     }	
 };
+void Arena::applyFootprint(int row, int col, const Offset* cells, int count, int minDmg, int maxDmg)
+{
+    for (int i = 0; i < count; i++)
+    {
+        int r = row + cells[i].dr;
+        int c = col + cells[i].dc;
+
+        // ---- BOUNDS CHECK ----
+        if (r >= 0 && r < mHeight && c >= 0 && c < mWidth)
+            applyDamageToCell(r, c, minDmg, maxDmg);
+    }
+};
 void Arena::applyDamageToCell(int row, int col, int minDmg, int maxDmg)
 {
-	std::string& cell = mGrid[row][col];
+	Cell& cell = cellAt(row, col);
 
     // Only robots can be damaged
-    if (cell.empty() || cell[0] != 'R')
+    if (cell.type != 'R')
         return;
 
-    // Look up robot by its grid token, e.g. "R@", "R$"
-    auto it = mRobots.find(cell);
-    if (it == mRobots.end() || !it->second)
+    // The cell holds the robot's index, so no lookup by grid token
+    RobotBase* target = mRobots[cell.robot];
+    if (!target)
         return;
 
-    RobotBase* target = it->second;
+    // a robot stuck in an overrunning call is out of reach until it returns
+    if (isRobotBusy(cell.robot))
+        return;
 
     // ---- BASE DAMAGE ----
-    int baseDamage = minDmg + (rand() % (maxDmg - minDmg + 1));
+    int baseDamage = mRng.range(minDmg, maxDmg);
 
     int armor = target->get_armor();
 
@@ -383,26 +493,22 @@ void Arena::applyDamageToCell(int row, int col, int minDmg, int maxDmg)
     int finalDamage = static_cast<int>(baseDamage * reductionFactor);
 
     // ---- APPLY DAMAGE ----
-    target->take_damage(finalDamage);
+    bool died = damageRobot(cell.robot, finalDamage);
 
     // ---- ARMOR ALWAYS DROPS BY 1 ----
     target->reduce_armor(1);
 
     // ---- CHECK FOR DEATH ----
-    if (target->get_health() <= 0) {
-        // Robot is dead: disable movement and relabel on the grid.
-
-        target->disable_movement();
+    if (died) {
+        // Robot is dead (movement already disabled): relabel on the grid.
 
-        // Keep the special character but change the leading 'R' to 'X'
+        // Keep the robot index but change the 'R' to 'X'
         // e.g. "R@" -> "X@", "R!" -> "X!".
-        if (!cell.empty()) {
-            cell[0] = 'X';
-        }
+        setOccupant(row, col, 'X', cell.robot);
 
         // From now on:
-        // - this tile will NOT be treated as a robot (cell[0] != 'R')
-        // - you still know *which* robot died by looking at "X@" etc
+        // - this tile will NOT be treated as a robot (type != 'R')
+        // - you still know *which* robot died by its robot index
     }
 };
 std::vector<std::pair<int,int>> Arena::radarPath(int sx, int sy, int direction) const
@@ -477,48 +583,307 @@ std::vector<std::pair<int,int>> Arena::radarPath(int sx, int sy, int direction)
 
     return coords;
 };
-void Arena::get_radar_results(RobotBase* robot, int radar_dir, std::vector<RadarObj>& radar_results)
+void Arena::scanCell(int r, int c, std::vector<RadarObj>& radar_results) const
+{
+    const Cell& cell = cellAt(r, c);
+
+    // Skip empty tiles
+    if (cell.type == '.')
+        return;
+
+    // The cell type is the RadarObj type
+    char type = cell.type;  // 'R', 'X', 'M', 'F', 'P'
+
+    // Only accept valid radar types
+    if (type == 'R' || type == 'X' ||
+        type == 'M' || type == 'F' || type == 'P')
+    {
+        radar_results.emplace_back(type, r, c);
+    }
+}
+void Arena::get_radar_results(RobotBase* robot, int radar_dir, std::vector<RadarObj>& radar_results) const
 {
     if (!robot) return;
 
-    // Clear any previous scan data
+    // Clear any previous scan data (keeps the caller's capacity)
     radar_results.clear();
 
     int sx, sy;
     robot->get_current_location(sx, sy);
 
-    // Get all coordinates the radar touches
-    std::vector<std::pair<int,int>> scanCoords =
-        radarPath(sx, sy, radar_dir);
-
-    // Scan each coordinate
-    for (const auto& [r, c] : scanCoords)
+    // Same cells in the same order as radarPath, without building the
+    // coordinate list; directional rays skip empty cells via mOccupied.
+    if (radar_dir == 0)
     {
-        const std::string& cell = mGrid[r][c];
+        for (int dr = -1; dr <= 1; dr++)
+        {
+            for (int dc = -1; dc <= 1; dc++)
+            {
+                // Skip the robot's own cell
+                if (dr == 0 && dc == 0)
+                    continue;
+
+                int r = sx + dr;
+                int c = sy + dc;
 
-        // Skip empty tiles
-        if (cell == ".")
+                if (r >= 0 && r < mHeight && c >= 0 && c < mWidth)
+                    scanCell(r, c, radar_results);
+            }
+        }
+        return;
+    }
+
+    // Direction must be 1–8
+    if (radar_dir < 1 || radar_dir > 8)
+        return;
+
+    // ---- 3-wide ray, jumping between occupied cells only ----
+    mOccupied.forEachOnRay(sx, sy,
+                           directions[radar_dir].first,
+                           directions[radar_dir].second,
+                           1,
+                           [&](int r, int c) { scanCell(r, c, radar_results); });
+}
+void Arena::setSimultaneousRadar(bool enabled, ThreadPool* pool)
+{
+    mSimultaneousRadar = enabled;
+    mRadarPool = pool;
+}
+void Arena::setCallbackDeadline(int micros)
+{
+    mRunners.clear();
+    if (micros <= 0)
+        return;
+
+    for (RobotBase* robot : mRobots)
+        mRunners.push_back(std::make_unique<RobotRunner>(robot, std::chrono::microseconds(micros)));
+}
+int Arena::getOverruns(int index) const
+{
+    return mRunners.empty() ? 0 : mRunners[index]->overruns();
+}
+bool Arena::isRobotBusy(int index) const
+{
+    return !mRunners.empty() && mRunners[index]->busy();
+}
+std::vector<int> Arena::retireBusyRobots()
+{
+    std::vector<int> retired;
+    for (int index = 0; index < static_cast<int>(mRobots.size()); index++)
+    {
+        if (!isRobotBusy(index))
             continue;
 
-        // First character defines RadarObj type
-        char type = cell[0];  // 'R', 'X', 'M', 'F', 'P'
+        // A busy robot is alive (nothing damages it mid-call), and the
+        // grid rather than the robot says where it stands
+        for (size_t cell = 0; cell < mCells.size(); cell++)
+        {
+            if (mCells[cell].type == 'R' && mCells[cell].robot == index)
+            {
+                setOccupant(static_cast<int>(cell) / mWidth, static_cast<int>(cell) % mWidth, 'X', index);
+                break;
+            }
+        }
+        robotDied(index);
+        retired.push_back(index);
+    }
+    return retired;
+}
+void Arena::enableProfiling(LatencyProfiler::Clock clock)
+{
+    mProfiler = std::make_unique<LatencyProfiler>(static_cast<int>(mRobots.size()), clock);
+}
+void Arena::printProfile(std::ostream& os) const
+{
+    if (mProfiler)
+        mProfiler->report(os, mRobotIds);
+}
+bool Arena::startReplay(const std::string& path)
+{
+    if (mRobots.size() > static_cast<size_t>(kReplayMaxRobots))
+        return false;
+
+    auto replay = std::make_unique<ReplayWriter>();
+    if (!replay->open(path))
+        return false;
 
-        // Only accept valid radar types
-        if (type == 'R' || type == 'X' ||
-            type == 'M' || type == 'F' || type == 'P')
+    std::vector<std::string> names;
+    std::vector<int> health;
+    for (RobotBase* robot : mRobots)
+    {
+        names.push_back(robot ? robot->m_name : std::string());
+        health.push_back(robot ? robot->get_health() : 0);
+    }
+    replay->writeHeader(mSeed, mHeight, mWidth, mRobotIds, names, health, mCells);
+
+    mReplay = std::move(replay);
+    return true;
+}
+bool Arena::finishReplay()
+{
+    if (!mReplay)
+        return true;
+    bool written = mReplay->close(mRound);
+    mReplay.reset();
+    return written;
+}
+void Arena::snapshot(ArenaSnapshot& snapshot) const
+{
+    snapshot.cells = mCells;
+    snapshot.occupied = mOccupied;
+    if (snapshot.robots.size() == mRobots.size())
+    {
+        // copy over the saved stand-ins, keeping their storage
+        for (size_t index = 0; index < mRobots.size(); index++)
+            static_cast<RobotBase&>(snapshot.robots[index]) = *mRobots[index];
+    }
+    else
+    {
+        snapshot.robots.clear();
+        for (RobotBase* robot : mRobots)
+            snapshot.robots.emplace_back(*robot);
+    }
+    snapshot.rng = mRng;
+    snapshot.alive = mAlive;
+    snapshot.aliveIndexSum = mAliveIndexSum;
+    snapshot.deaths = mDeaths;
+    snapshot.round = mRound;
+}
+void Arena::restore(const ArenaSnapshot& snapshot)
+{
+    if (snapshot.cells.size() != mCells.size() || snapshot.robots.size() != mRobots.size())
+        throw std::invalid_argument("snapshot is of a different arena");
+
+    mCells = snapshot.cells;
+    mOccupied = snapshot.occupied;
+    // only the RobotBase part: the robot keeps its own memory
+    for (size_t index = 0; index < mRobots.size(); index++)
+        if (!isRobotBusy(static_cast<int>(index)))
+            static_cast<RobotBase&>(*mRobots[index]) = snapshot.robots[index];
+    mRng = snapshot.rng;
+    mAlive = snapshot.alive;
+    mAliveIndexSum = snapshot.aliveIndexSum;
+    mDeaths = snapshot.deaths;
+    mRound = snapshot.round;
+}
+std::unique_ptr<Arena> Arena::fork() const
+{
+    return std::unique_ptr<Arena>(new Arena(*this, ForkTag{}));
+}
+bool Arena::callRadarDirection(int index, int& direction)
+{
+    ProfileTimer timer(mProfiler.get(), index, LatencyProfiler::RadarDirection);
+    if (!mRunners.empty())
+        return mRunners[index]->radarDirection(direction);
+    mRobots[index]->get_radar_direction(direction);
+    return true;
+}
+bool Arena::callProcessRadar(int index, const std::vector<RadarObj>& results)
+{
+    ProfileTimer timer(mProfiler.get(), index, LatencyProfiler::ProcessRadar);
+    if (!mRunners.empty())
+        return mRunners[index]->processRadar(results);
+    mRobots[index]->process_radar_results(results);
+    return true;
+}
+bool Arena::callShotLocation(int index, bool& shoots, int& row, int& col)
+{
+    ProfileTimer timer(mProfiler.get(), index, LatencyProfiler::ShotLocation);
+    if (!mRunners.empty())
+        return mRunners[index]->shotLocation(shoots, row, col);
+    shoots = mRobots[index]->get_shot_location(row, col);
+    return true;
+}
+bool Arena::callMoveDirection(int index, int& direction, int& distance)
+{
+    ProfileTimer timer(mProfiler.get(), index, LatencyProfiler::MoveDirection);
+    if (!mRunners.empty())
+        return mRunners[index]->moveDirection(direction, distance);
+    mRobots[index]->get_move_direction(direction, distance);
+    return true;
+}
+void Arena::forfeitTurn(int index)
+{
+    if (mReplay)
+        mReplay->event(ReplayForfeit, 0, index, 0, 0);
+}
+void Arena::scanAllRadars()
+{
+    mRadarBuffers.resize(mRobots.size());
+    mRadarScanned.assign(mRobots.size(), 0);
+    mRadarDirs.resize(mRobots.size());
+
+    // Nothing moves until every scan is done, so each robot sees the
+    // board as it was at the start of the round. Robots only touch their
+    // own state and buffer, and the grid is only read.
+    auto scan = [this](int index)
+    {
+        RobotBase* robot = mRobots[index];
+        // a robot still in an overrunning call is not even read; its
+        // turn is forfeited for want of a scan
+        if (!robot || isRobotBusy(index) || robot->get_health() <= 0)
+            return;
+
+        int radar_dir = 0;
+        if (!callRadarDirection(index, radar_dir))
+            return;
         {
-            radar_results.emplace_back(type, r, c);
+            ProfileTimer timer(mProfiler.get(), index, LatencyProfiler::ArenaRadar);
+            get_radar_results(robot, radar_dir, mRadarBuffers[index]);
         }
+        mRadarDirs[index] = radar_dir;
+        mRadarScanned[index] = 1;
+    };
+
+    int count = static_cast<int>(mRobots.size());
+    if (mRadarPool)
+    {
+        mRadarPool->parallelFor(count, scan);
+    }
+    else
+    {
+        for (int index = 0; index < count; index++)
+            scan(index);
     }
 }
 void Arena::iterate()
 {
-    // Loop through each robot in the arena
-    for (auto& [name, robot] : mRobots)
+    mRound++;
+    mDeaths.clear();
+    if (mReplay)
+    {
+        mReplay->event(ReplayRound, 0, -1, mRound, 0);
+        if (mReplay->keyframeDue())
+        {
+            std::vector<int> health;
+            for (int index = 0; index < static_cast<int>(mRobots.size()); index++)
+            {
+                if (isRobotBusy(index))
+                    health.push_back(mRunners[index]->healthAtCall());
+                else
+                    health.push_back(mRobots[index] ? mRobots[index]->get_health() : 0);
+            }
+            mReplay->keyframe(mRound, mCells, health);
+        }
+    }
+
+    if (mSimultaneousRadar)
+        scanAllRadars();
+
+    // Loop through each robot in the arena, in grid token order
+    for (int index = 0; index < static_cast<int>(mRobots.size()); index++)
     {
+        RobotBase* robot = mRobots[index];
         if (!robot)
             continue;
 
+        // ---- STILL IN LAST TURN'S OVERRUN: ITS THREAD OWNS IT ----
+        if (isRobotBusy(index))
+        {
+            forfeitTurn(index);
+            continue;
+        }
+
         // ---- SKIP DEAD ROBOTS ----
         if (robot->get_health() <= 0)
             continue;
@@ -527,22 +892,64 @@ void Arena::iterate()
         robot->get_current_location(sx, sy);
 
         // ---- RADAR PHASE ----
-        int radar_dir = 0;
-        robot->get_radar_direction(radar_dir);   // ✅ reference output
+        // (a callback that misses the deadline forfeits the whole turn)
+        if (mSimultaneousRadar)
+        {
+            // already scanned with everyone else at the start of the round
+            if (!mRadarScanned[index])
+            {
+                forfeitTurn(index);
+                continue;
+            }
+            if (mReplay)
+                mReplay->event(ReplayTurn, mRadarDirs[index], index, 0, 0);
+            if (!callProcessRadar(index, mRadarBuffers[index]))
+            {
+                forfeitTurn(index);
+                continue;
+            }
+        }
+        else
+        {
+            int radar_dir = 0;
+            if (!callRadarDirection(index, radar_dir))   // ✅ reference output
+            {
+                forfeitTurn(index);
+                continue;
+            }
+            if (mReplay)
+                mReplay->event(ReplayTurn, radar_dir, index, 0, 0);
 
-        std::vector<RadarObj> radar_results;
-        get_radar_results(robot, radar_dir, radar_results);
+            // one buffer for every robot's scan, so no allocation per turn
+            {
+                ProfileTimer timer(mProfiler.get(), index, LatencyProfiler::ArenaRadar);
+                get_radar_results(robot, radar_dir, mRadarResults);
+            }
 
-        robot->process_radar_results(radar_results);
+            if (!callProcessRadar(index, mRadarResults))
+            {
+                forfeitTurn(index);
+                continue;
+            }
+        }
 
         // ---- ACTION PHASE ----
         int shot_row = 0;
         int shot_col = 0;
+        bool shoots = false;
+        if (!callShotLocation(index, shoots, shot_row, shot_col))   // ✅ bool return + ref outputs
+        {
+            forfeitTurn(index);
+            continue;
+        }
 
         // If robot chooses to shoot
-        if (robot->get_shot_location(shot_row, shot_col))   // ✅ bool return + ref outputs
+        if (shoots)
         {
             WeaponType weapon = robot->get_weapon();
+            if (mReplay)
+                mReplay->event(ReplayShot, weapon, index, shot_row, shot_col);
+            ProfileTimer timer(mProfiler.get(), index, LatencyProfiler::ArenaShot);
             handle_shot(weapon, robot, shot_row, shot_col);
         }
         else
@@ -551,9 +958,16 @@ void Arena::iterate()
             int move_dir = 0;
             int move_dist = 0;
 
-            robot->get_move_direction(move_dir, move_dist);  // ✅ both by reference
+            if (!callMoveDirection(index, move_dir, move_dist))  // ✅ both by reference
+            {
+                forfeitTurn(index);
+                continue;
+            }
+            if (mReplay)
+                mReplay->event(ReplayMove, move_dir, index, move_dist, 0);
 
-            handle_movement(name, robot, move_dir, move_dist);
+            ProfileTimer timer(mProfiler.get(), index, LatencyProfiler::ArenaMove);
+            handle_movement(index, robot, move_dir, move_dist);
         }
     }
 }
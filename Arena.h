@@ -4,33 +4,175 @@
 #include <string>
 #include "RobotBase.h"
 #include "RadarObj.h"
+#include "ArenaRng.h"
+#include "OccupancyIndex.h"
+#include "WeaponFootprints.h"
+#include "LatencyProfiler.h"
 #include <utility>
 #include <iostream>
 #include <map>
 #include <memory>
+class ThreadPool;
+class RobotRunner;
+class ReplayWriter;
+struct ArenaSnapshot;
+// One square of the arena, in two layers. 'terrain' is what the square
+// itself holds ('.', 'P', 'M' or 'F'); 'type' is the character shown on
+// the board, which is the terrain unless a robot ('R', or 'X' once dead)
+// stands on it. For 'R' and 'X' cells 'robot' is the index of that robot
+// (see mRobotIds), otherwise -1.
+struct Cell {
+	char type;
+	char terrain;
+	int robot;
+};
 class Arena {
 	public:
-		Arena(int height, int width, std::map<std::string, RobotBase*> robots, int num_of_obstacles);
-		void get_radar_results(RobotBase* robot, int radar_dir, std::vector<RadarObj>& radar_results);
+		// num_of_obstacles get a random type; num_pits/mounds/flames are exact counts.
+		// Obstacles go inside the border, robots anywhere; throws
+		// std::runtime_error if they do not fit.
+		Arena(int height, int width, std::map<std::string, RobotBase*> robots, int num_of_obstacles, std::uint64_t seed = 0,
+			int num_pits = 0, int num_mounds = 0, int num_flames = 0);
+		~Arena();
+		void get_radar_results(RobotBase* robot, int radar_dir, std::vector<RadarObj>& radar_results) const;
 		void handle_shot(WeaponType weapon, RobotBase* robot, int shot_row, int shot_col);
-		void handle_movement(const std::string& name, RobotBase* robot, int direction, int distance);
+		void handle_movement(int index, RobotBase* robot, int direction, int distance);
 		void applyDamageToCell(int row, int col, int minDmg, int maxDmg);
 		std::vector<std::pair<int, int>> radarPath(int sx, int sy, int direction) const;
 		std::vector<std::pair<int, int>> railgunPath(int sx, int sy, int tx, int ty);
 		std::vector<std::pair<int, int>> flamePath(int sx, int sy, int tx, int ty);
 		std::vector<std::pair<int, int>> grenadeRadius(int x, int y);
 		void printState(std::ostream& os);
-		std::string getWinner();
-		int getAlive();
+		// grid token of the last robot standing, "none" otherwise
+		std::string getWinner() const;
+		// living robots, kept as they die rather than counted each call
+		int getAlive() const { return mAlive; }
+		// indexes of the robots that died in the last iterate(), in order
+		const std::vector<int>& getDeaths() const { return mDeaths; }
 		void placeItems();
 		void iterate();
+		// Simultaneous radar: every living robot picks its radar direction
+		// and is scanned at the start of the round, before anyone acts, on
+		// pool's threads if given. Off by default (scan right before acting).
+		void setSimultaneousRadar(bool enabled, ThreadPool* pool = nullptr);
+		// Runs each robot's callbacks on its own thread with this budget per
+		// call; a robot that overruns forfeits its turn. 0 turns it off and
+		// calls robots directly (the default).
+		void setCallbackDeadline(int micros);
+		bool hasCallbackDeadline() const { return !mRunners.empty(); }
+		// callbacks of this robot that missed the deadline
+		int getOverruns(int index) const;
+		// True while this robot is still inside a call that overran. Its
+		// RobotBase belongs to its own thread until then: the arena skips
+		// it for damage and restores, and callers must not read its stats.
+		bool isRobotBusy(int index) const;
+		// Ends the game for robots still stuck in an overrunning call:
+		// each counts as dead, a wreck on its cell, so getWinner() and
+		// any tally agree. Their RobotBase is not touched. Returns them.
+		std::vector<int> retireBusyRobots();
+		// Times every robot callback and the arena's radar/shot/move handling
+		// per robot from now on. Off unless called; costs a null check then.
+		void enableProfiling(LatencyProfiler::Clock clock);
+		bool isProfiling() const { return mProfiler != nullptr; }
+		void printProfile(std::ostream& os) const;
+		// Records the game from here on to a binary replay file (see
+		// ReplayLog.h), starting with the current board. False if the file
+		// cannot be created or there are more robots than the log can
+		// name (kReplayMaxRobots). The log is finished by finishReplay(),
+		// or when the arena goes away.
+		bool startReplay(const std::string& path);
+		// Ends the log now; false if any of it failed to reach the file.
+		bool finishReplay();
+		int getHeight() const { return mHeight; }
+		int getWidth() const { return mWidth; }
+		const Cell& getCell(int row, int col) const { return cellAt(row, col); }
+		// grid token ("R@") of the robot with this Cell::robot index
+		const std::string& getRobotId(int index) const { return mRobotIds[index]; }
+		int getRobotCount() const { return static_cast<int>(mRobots.size()); }
+		// length of the longest grid token, at least 2
+		int getRobotIdWidth() const { return mRobotIdWidth; }
+		RobotBase* getRobot(int index) const { return mRobots[index]; }
+		// Saves everything a turn can change (grid, robot stats and
+		// positions, RNG, alive count, round) into snapshot, reusing its
+		// storage, and puts it back. Only the robots' RobotBase part is
+		// restored, never their own state, and busy robots are left as
+		// they are. Restores are not recorded in a replay. See
+		// ArenaSnapshot.h.
+		void snapshot(ArenaSnapshot& snapshot) const;
+		void restore(const ArenaSnapshot& snapshot);
+		// A copy of this arena with the same state but its own stand-in
+		// robots, which never act on their own: drive it with
+		// handle_shot/handle_movement on getRobot(i) to try things out
+		// without touching this arena. No deadline, profiling or replay.
+		std::unique_ptr<Arena> fork() const;
 	protected:
-		std::vector<std::vector<std::string>> mGrid;
+		struct ForkTag {};
+		Arena(const Arena& source, ForkTag);
+		Cell& cellAt(int row, int col) { return mCells[row * mWidth + col]; }
+		const Cell& cellAt(int row, int col) const { return mCells[row * mWidth + col]; }
+		// every grid write goes through here to keep mOccupied current
+		void setCell(int row, int col, Cell cell);
+		// puts robot 'robot' ('R' or 'X') on a cell, keeping its terrain
+		void setOccupant(int row, int col, char type, int robot);
+		// takes the robot off a cell, showing its terrain again
+		void clearOccupant(int row, int col);
+		// appends the cell to radar_results unless it is empty
+		void scanCell(int r, int c, std::vector<RadarObj>& radar_results) const;
+		// damages every on-board cell of a footprint centred on (row, col)
+		void applyFootprint(int row, int col, const Offset* cells, int count, int minDmg, int maxDmg);
+		// simultaneous radar phase: fills mRadarBuffers for living robots
+		void scanAllRadars();
+		// Robot callbacks go through these so the deadline applies; false
+		// means the robot overran (or is still busy) and forfeits its turn.
+		bool callRadarDirection(int index, int& direction);
+		bool callProcessRadar(int index, const std::vector<RadarObj>& results);
+		bool callShotLocation(int index, bool& shoots, int& row, int& col);
+		bool callMoveDirection(int index, int& direction, int& distance);
+		// a robot lost its turn to the deadline
+		void forfeitTurn(int index);
+		// Takes damage off a living robot and logs it; true if that killed
+		// it, which also disables its movement and calls robotDied().
+		bool damageRobot(int index, int damage);
+		// a robot's health just dropped to 0 or below, once per robot
+		void robotDied(int index);
+		// row-major, mHeight * mWidth cells
+		std::vector<Cell> mCells;
+		// which cells are not '.', for radar and railgun rays
+		OccupancyIndex mOccupied;
 		int mHeight;
 		int mWidth;
-		std::map<std::string, RobotBase*> mRobots;
+		// robots in grid token order, indexed by Cell::robot
+		std::vector<RobotBase*> mRobots;
+		// robot grid tokens ("R@", "R#", ...), parallel to mRobots
+		std::vector<std::string> mRobotIds;
+		int mRobotIdWidth;
 		int mObstacles;
+		int mPits;
+		int mMounds;
+		int mFlames;
 		int mAlive;
+		// sum of the living robots' indexes: the winner's once one is left
+		long long mAliveIndexSum;
+		std::vector<int> mDeaths;
+		ArenaRng mRng;
+		std::string mPrintBuffer;
+		std::vector<RadarObj> mRadarResults;
+		bool mSimultaneousRadar;
+		ThreadPool* mRadarPool;
+		// per-robot scans for simultaneous radar, parallel to mRobots
+		std::vector<std::vector<RadarObj>> mRadarBuffers;
+		// whether each robot's simultaneous scan finished in time
+		std::vector<char> mRadarScanned;
+		// one per robot while a callback deadline is set, else empty
+		std::vector<std::unique_ptr<RobotRunner>> mRunners;
+		std::unique_ptr<LatencyProfiler> mProfiler;
+		std::uint64_t mSeed;
+		int mRound;   // iterate() calls so far
+		// radar direction each robot chose in the simultaneous scan
+		std::vector<int> mRadarDirs;
+		std::unique_ptr<ReplayWriter> mReplay;
+		// a fork's robots, which mRobots points at
+		std::vector<std::unique_ptr<RobotBase>> mStandIns;
 
 };
 #endif
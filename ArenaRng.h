@@ -0,0 +1,37 @@
+#ifndef _ARENARNG_H_
+#define _ARENARNG_H_
+#include <cstdint>
+// Per-arena random number generator (xorshift64*, seeded through
+// splitmix64). It is a single 64-bit word, so every Arena can own one,
+// games replay exactly from their seed and arenas on different threads
+// never touch shared state the way rand() does.
+class ArenaRng {
+	public:
+		explicit ArenaRng(std::uint64_t seed = 0){ reseed(seed); }
+		void reseed(std::uint64_t seed){
+			std::uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			z ^= z >> 31;
+			// xorshift must never hold zero
+			mState = z ? z : 0x9E3779B97F4A7C15ULL;
+		}
+		std::uint64_t next(){
+			mState ^= mState >> 12;
+			mState ^= mState << 25;
+			mState ^= mState >> 27;
+			return mState * 0x2545F4914F6CDD1DULL;
+		}
+		// uniform in [0, n), n > 0
+		int below(int n){
+			std::uint64_t high = next() >> 32;
+			return static_cast<int>((high * static_cast<std::uint64_t>(n)) >> 32);
+		}
+		// uniform in [low, high]
+		int range(int low, int high){
+			return low + below(high - low + 1);
+		}
+	private:
+		std::uint64_t mState;
+};
+#endif
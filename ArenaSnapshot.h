@@ -0,0 +1,37 @@
+#ifndef _ARENASNAPSHOT_H_
+#define _ARENASNAPSHOT_H_
+#include "Arena.h"
+#include "ArenaRng.h"
+#include "OccupancyIndex.h"
+#include "RobotBase.h"
+#include <vector>
+// A robot's RobotBase state (health, armor, speed, weapon, grenades,
+// position, name) without the robot: it scans locally and never shoots
+// or moves. Robots cannot be copied whole, so snapshots and forks keep
+// these; assigning one back onto a robot's RobotBase restores its stats
+// and leaves the robot's own members alone.
+class RobotStandIn final : public RobotBase {
+	public:
+		explicit RobotStandIn(const RobotBase& robot): RobotBase(robot){}
+		void get_radar_direction(int& radar_direction) override { radar_direction = 0; }
+		void process_radar_results(const std::vector<RadarObj>&) override {}
+		bool get_shot_location(int&, int&) override { return false; }
+		void get_move_direction(int& direction, int& distance) override { direction = 0; distance = 0; }
+};
+// What Arena::snapshot saves. Everything but the robots is flat, so
+// taking snapshot after snapshot into the same object copies that part
+// into the storage already there. The robots go through RobotBase's copy
+// assignment, which copies each m_name as well and so may allocate for
+// long names. Restore copies into the arena's existing storage the same
+// way.
+struct ArenaSnapshot {
+	std::vector<Cell> cells;
+	OccupancyIndex occupied;
+	std::vector<RobotStandIn> robots;   // by robot index
+	ArenaRng rng;
+	int alive = 0;
+	long long aliveIndexSum = 0;
+	std::vector<int> deaths;
+	int round = 0;
+};
+#endif
@@ -0,0 +1,91 @@
+#include "FrameRenderer.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <unistd.h>
+static int digits(int value){
+	int count = 1;
+	while(value >= 10){
+		value /= 10;
+		count++;
+	};
+	return count;
+};
+FrameRenderer::FrameRenderer():
+	mLabelWidth(1),
+	mColumnWidth(3){
+};
+void FrameRenderer::layout(int height, int width, int idWidth){
+	mLabelWidth = digits(std::max(height - 1, 0));
+	mColumnWidth = std::max({3, digits(std::max(width - 1, 0)) + 1, idWidth + 1});
+
+	// a full board plus room for cursor codes and stat lines
+	size_t line = static_cast<size_t>(mLabelWidth) + static_cast<size_t>(width) * mColumnWidth + 16;
+	mBuffer.reserve(line * (height + 1) * 2 + 4096);
+};
+void FrameRenderer::appendNumber(long long value, int width){
+	char text[24];
+	auto result = std::to_chars(text, text + sizeof(text), value);
+	int length = static_cast<int>(result.ptr - text);
+	if(width > length){
+		mBuffer.append(width - length, ' ');
+	};
+	mBuffer.append(text, length);
+};
+void FrameRenderer::appendCursor(int line, int column){
+	mBuffer.append("\x1b[");
+	appendNumber(line);
+	mBuffer.push_back(';');
+	appendNumber(column);
+	mBuffer.push_back('H');
+};
+void FrameRenderer::appendCell(const Cell& cell, const Arena& arena){
+	if(cell.type == 'R' || cell.type == 'X'){
+		// "R@" style tokens: type plus the symbol(s) after the 'R'
+		const std::string& id = arena.getRobotId(cell.robot);
+		int length = static_cast<int>(id.size());
+		if(mColumnWidth > length){
+			mBuffer.append(mColumnWidth - length, ' ');
+		};
+		mBuffer.push_back(cell.type);
+		mBuffer.append(id, 1, std::string::npos);
+	}else{
+		mBuffer.append(mColumnWidth - 1, ' ');
+		mBuffer.push_back(cell.type);
+	};
+};
+void FrameRenderer::appendBoard(const Arena& arena){
+	int height = arena.getHeight();
+	int width = arena.getWidth();
+
+	mBuffer.append(mLabelWidth, ' ');
+	for(int col = 0; col < width; col++){
+		appendNumber(col, mColumnWidth);
+	};
+	mBuffer.push_back('\n');
+
+	for(int row = 0; row < height; row++){
+		appendNumber(row, mLabelWidth);
+		for(int col = 0; col < width; col++){
+			appendCell(arena.getCell(row, col), arena);
+		};
+		mBuffer.push_back('\n');
+	};
+};
+bool FrameRenderer::writeTo(int fd) const{
+	const char* data = mBuffer.data();
+	size_t left = mBuffer.size();
+	// one write() unless the terminal takes it in pieces
+	while(left > 0){
+		ssize_t written = ::write(fd, data, left);
+		if(written < 0){
+			if(errno == EINTR){
+				continue;
+			};
+			return false;
+		};
+		data += written;
+		left -= static_cast<size_t>(written);
+	};
+	return true;
+};
@@ -0,0 +1,34 @@
+#ifndef _FRAMERENDERER_H_
+#define _FRAMERENDERER_H_
+#include "Arena.h"
+#include <string>
+#include <string_view>
+// Builds terminal output for the arena in one reusable buffer and writes
+// it with a single write() call. Board layout: a row-number column, then
+// every arena column the same width with tokens right-aligned, so the
+// column numbers stay over their cells past column 9.
+class FrameRenderer {
+	public:
+		FrameRenderer();
+		// sizes the columns for a board and its longest robot token and
+		// reserves room for a full frame
+		void layout(int height, int width, int idWidth = 2);
+		void clear() { mBuffer.clear(); }
+		// column numbers and every row, one line each
+		void appendBoard(const Arena& arena);
+		void appendCell(const Cell& cell, const Arena& arena);
+		void appendText(std::string_view text) { mBuffer.append(text); }
+		void appendNumber(long long value, int width = 0);
+		// ANSI cursor move to a 1-based screen line and column
+		void appendCursor(int line, int column);
+		// screen column (1-based) where a board column starts
+		int cellColumn(int col) const { return 1 + mLabelWidth + col * mColumnWidth; }
+		const std::string& buffer() const { return mBuffer; }
+		// writes the whole buffer to fd; false on error
+		bool writeTo(int fd) const;
+	private:
+		std::string mBuffer;
+		int mLabelWidth;
+		int mColumnWidth;
+};
+#endif
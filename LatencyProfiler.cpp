@@ -0,0 +1,67 @@
+#include "LatencyProfiler.h"
+#include <bit>
+#include <chrono>
+#include <iomanip>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ROBOTWARZ_HAVE_RDTSC 1
+#endif
+static const char* const kProbeNames[LatencyProfiler::ProbeCount] = {
+	"radar_direction", "process_radar", "shot_location", "move_direction",
+	"arena_radar", "arena_shot", "arena_move"
+};
+LatencyProfiler::LatencyProfiler(int robots, Clock clock):
+	mClock(clock),
+	mHistograms(static_cast<size_t>(robots) * ProbeCount){
+#ifndef ROBOTWARZ_HAVE_RDTSC
+	mClock = Nanoseconds;
+#endif
+};
+std::uint64_t LatencyProfiler::now() const{
+#ifdef ROBOTWARZ_HAVE_RDTSC
+	if(mClock == Cycles){
+		return __rdtsc();
+	};
+#endif
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+};
+void LatencyProfiler::record(int robot, Probe probe, std::uint64_t elapsed){
+	Histogram& histogram = mHistograms[static_cast<size_t>(robot) * ProbeCount + probe];
+	histogram.buckets[std::bit_width(elapsed)]++;
+	histogram.count++;
+	if(elapsed > histogram.max){
+		histogram.max = elapsed;
+	};
+};
+std::uint64_t LatencyProfiler::percentile(const Histogram& histogram, double fraction) const{
+	// smallest bucket holding at least fraction of the samples
+	std::uint64_t wanted = static_cast<std::uint64_t>(fraction * static_cast<double>(histogram.count) + 0.999999);
+	std::uint64_t seen = 0;
+	for(int b = 0; b < kBuckets; b++){
+		seen += histogram.buckets[b];
+		if(seen >= wanted && seen > 0){
+			std::uint64_t upper = b >= 64 ? UINT64_MAX : (std::uint64_t{1} << b) - 1;
+			return upper < histogram.max ? upper : histogram.max;
+		};
+	};
+	return histogram.max;
+};
+void LatencyProfiler::report(std::ostream& os, const std::vector<std::string>& robotIds) const{
+	os << "=========== latency (" << (mClock == Cycles ? "cycles" : "ns")
+	   << ", p50/p99 within 2x) ===========\n";
+	for(size_t robot = 0; robot < robotIds.size(); robot++){
+		for(int probe = 0; probe < ProbeCount; probe++){
+			const Histogram& histogram = mHistograms[robot * ProbeCount + probe];
+			if(histogram.count == 0){
+				continue;
+			};
+			os << std::left << std::setw(5) << robotIds[robot]
+			   << std::setw(16) << kProbeNames[probe] << std::right
+			   << "  n: " << std::setw(7) << histogram.count
+			   << "  p50: " << std::setw(10) << percentile(histogram, 0.50)
+			   << "  p99: " << std::setw(10) << percentile(histogram, 0.99)
+			   << "  max: " << std::setw(10) << histogram.max << "\n";
+		};
+	};
+};
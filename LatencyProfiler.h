@@ -0,0 +1,57 @@
+#ifndef _LATENCYPROFILER_H_
+#define _LATENCYPROFILER_H_
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+// Per-robot latency histograms for the four robot callbacks and the
+// arena's own handling of each turn. Samples land in power-of-two
+// buckets, so p50 and p99 are bucket upper bounds (within 2x) while max
+// is exact. Each robot's histograms are only written by the thread that
+// is running that robot's turn, so no locking is needed.
+class LatencyProfiler {
+	public:
+		enum Probe { RadarDirection, ProcessRadar, ShotLocation, MoveDirection,
+			ArenaRadar, ArenaShot, ArenaMove, ProbeCount };
+		// Cycles reads the time stamp counter where there is one (x86),
+		// and falls back to nanoseconds elsewhere.
+		enum Clock { Nanoseconds, Cycles };
+		LatencyProfiler(int robots, Clock clock);
+		std::uint64_t now() const;
+		void record(int robot, Probe probe, std::uint64_t elapsed);
+		// one line per robot and probe that has samples
+		void report(std::ostream& os, const std::vector<std::string>& robotIds) const;
+	private:
+		static const int kBuckets = 65;   // bucket b holds [2^(b-1), 2^b)
+		struct Histogram {
+			std::uint64_t buckets[kBuckets] = {};
+			std::uint64_t count = 0;
+			std::uint64_t max = 0;
+		};
+		std::uint64_t percentile(const Histogram& histogram, double fraction) const;
+		Clock mClock;
+		std::vector<Histogram> mHistograms;   // robot * ProbeCount + probe
+};
+// Times the enclosing scope into a profiler; does nothing without one.
+class ProfileTimer {
+	public:
+		ProfileTimer(LatencyProfiler* profiler, int robot, LatencyProfiler::Probe probe):
+			mProfiler(profiler),
+			mRobot(robot),
+			mProbe(probe),
+			mStart(profiler ? profiler->now() : 0){
+		}
+		~ProfileTimer(){
+			if(mProfiler){
+				mProfiler->record(mRobot, mProbe, mProfiler->now() - mStart);
+			}
+		}
+		ProfileTimer(const ProfileTimer&) = delete;
+		ProfileTimer& operator=(const ProfileTimer&) = delete;
+	private:
+		LatencyProfiler* mProfiler;
+		int mRobot;
+		LatencyProfiler::Probe mProbe;
+		std::uint64_t mStart;
+};
+#endif
@@ -0,0 +1,39 @@
+#ifndef _LINETRACE_H_
+#define _LINETRACE_H_
+#include <cstdlib>
+// Integer line stepping for shots. A shot from (row, col) toward
+// (row + dr, col + dc) advances one cell along the longer axis per step;
+// the other axis moves by round(k * minor / major), rounding halves away
+// from the shooter. Step k = 1, 2, ... gives each cell exactly once and
+// never the shooter's own cell. No floating point is involved.
+//
+// Spec example: (2,2) toward (4,5) gives (3,3) (3,4) (4,5) (5,6) (5,7)
+// (6,8) (7,9) ...
+class LineTrace {
+	public:
+		LineTrace(int dr, int dc):
+			mSignR((dr > 0) - (dr < 0)),
+			mSignC((dc > 0) - (dc < 0)),
+			mRowMajor(std::abs(dr) >= std::abs(dc)),
+			mMajor(mRowMajor ? std::abs(dr) : std::abs(dc)),
+			mMinor(mRowMajor ? std::abs(dc) : std::abs(dr)){
+		}
+		// a zero vector has no direction, so nothing is hit
+		bool empty() const { return mMajor == 0; }
+		int rowOffset(int k) const { return mSignR * (mRowMajor ? k : minorOffset(k)); }
+		int colOffset(int k) const { return mSignC * (mRowMajor ? minorOffset(k) : k); }
+		// unit step across the line (for 3-wide flames); both
+		// components are set on an exact diagonal
+		int perpRow() const { return (mMajor == mMinor || !mRowMajor) ? -mSignC : 0; }
+		int perpCol() const { return (mMajor == mMinor || mRowMajor) ? mSignR : 0; }
+	private:
+		int minorOffset(int k) const {
+			return static_cast<int>((2LL * k * mMinor + mMajor) / (2LL * mMajor));
+		}
+		int mSignR;
+		int mSignC;
+		bool mRowMajor;
+		int mMajor;
+		int mMinor;
+};
+#endif
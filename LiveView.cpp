@@ -0,0 +1,93 @@
+#include "LiveView.h"
+// screen lines (1-based): round banner, column numbers, then the board
+static const int kBoardTop = 3;
+
+LiveView::LiveView(int fd):
+	mFd(fd),
+	mHeight(0),
+	mWidth(0),
+	mLinesUsed(0),
+	mStarted(false){
+};
+LiveView::~LiveView(){
+	finish();
+};
+void LiveView::draw(const Arena& arena, int round, const std::map<std::string, RobotBase*>& robots){
+	mFrame.clear();
+
+	if(!mStarted || arena.getHeight() != mHeight || arena.getWidth() != mWidth){
+		// ---- FIRST FRAME: CLEAR, HIDE CURSOR, WHOLE BOARD ----
+		mHeight = arena.getHeight();
+		mWidth = arena.getWidth();
+		mFrame.layout(mHeight, mWidth, arena.getRobotIdWidth());
+		mFrame.appendText("\x1b[2J\x1b[?25l");
+		mFrame.appendCursor(kBoardTop - 1, 1);
+		mFrame.appendBoard(arena);
+
+		mShown.resize(static_cast<size_t>(mHeight) * mWidth);
+		for(int row = 0; row < mHeight; row++){
+			for(int col = 0; col < mWidth; col++){
+				mShown[row * mWidth + col] = arena.getCell(row, col);
+			};
+		};
+		mStarted = true;
+	}else{
+		// ---- ONLY REDRAW CELLS THAT CHANGED ----
+		for(int row = 0; row < mHeight; row++){
+			int cursorCol = -1;   // column the cursor sits in front of, if known
+			for(int col = 0; col < mWidth; col++){
+				const Cell& cell = arena.getCell(row, col);
+				Cell& shown = mShown[row * mWidth + col];
+				if(cell.type != shown.type || cell.robot != shown.robot){
+					if(cursorCol != col){
+						mFrame.appendCursor(kBoardTop + row, mFrame.cellColumn(col));
+					};
+					mFrame.appendCell(cell, arena);
+					shown = cell;
+					cursorCol = col + 1;
+				};
+			};
+		};
+	};
+
+	mFrame.appendCursor(1, 1);
+	mFrame.appendText("=========== round ");
+	mFrame.appendNumber(round);
+	mFrame.appendText(" ===========\x1b[K");
+
+	// ---- ROBOT STATS UNDER THE BOARD, ONE LINE EACH ----
+	int line = kBoardTop + mHeight + 1;
+	int index = -1;   // the arena holds the robots in map order
+	for(const auto& [name, robot] : robots){
+		index++;
+		if(!robot){
+			continue;
+		};
+		mFrame.appendCursor(line++, 1);
+		mFrame.appendText(name);
+		mFrame.appendText(" ");
+		if(arena.isRobotBusy(index)){
+			// its stats are not ours to read until the call returns
+			mFrame.appendText("(busy)\x1b[K");
+			continue;
+		};
+		mFrame.appendText(robot->print_stats());
+		if(robot->get_health() <= 0){
+			mFrame.appendText(" - is out");
+		};
+		mFrame.appendText("\x1b[K");
+	};
+	mLinesUsed = line;
+
+	mFrame.writeTo(mFd);
+};
+void LiveView::finish(){
+	if(!mStarted){
+		return;
+	};
+	mFrame.clear();
+	mFrame.appendCursor(mLinesUsed, 1);
+	mFrame.appendText("\x1b[?25h\n");
+	mFrame.writeTo(mFd);
+	mStarted = false;
+};
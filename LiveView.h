@@ -0,0 +1,29 @@
+#ifndef _LIVEVIEW_H_
+#define _LIVEVIEW_H_
+#include "Arena.h"
+#include "FrameRenderer.h"
+#include "RobotBase.h"
+#include <map>
+#include <string>
+#include <vector>
+// Watches a game in a terminal. The first frame draws the whole board;
+// after that only cells that changed since the previous frame are
+// rewritten, using ANSI cursor positioning, so the board stays in place.
+// Each frame goes out in one write() to fd.
+class LiveView {
+	public:
+		explicit LiveView(int fd);
+		~LiveView();
+		void draw(const Arena& arena, int round, const std::map<std::string, RobotBase*>& robots);
+		// leaves the cursor below the last frame
+		void finish();
+	private:
+		int mFd;
+		FrameRenderer mFrame;
+		std::vector<Cell> mShown;   // what the terminal shows, row-major
+		int mHeight;
+		int mWidth;
+		int mLinesUsed;
+		bool mStarted;
+};
+#endif
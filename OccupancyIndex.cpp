@@ -0,0 +1,114 @@
+#include "OccupancyIndex.h"
+#include <algorithm>
+#include <bit>
+void OccupancyIndex::reset(int height, int width){
+	mHeight = height;
+	mWidth = width;
+	mRowWords = (width + 63) / 64;
+	mColWords = (height + 63) / 64;
+	int diagonals = height + width - 1;
+	mRows.assign(static_cast<size_t>(height) * mRowWords, 0);
+	mCols.assign(static_cast<size_t>(width) * mColWords, 0);
+	mDiags.assign(static_cast<size_t>(diagonals) * mColWords, 0);
+	mAntiDiags.assign(static_cast<size_t>(diagonals) * mColWords, 0);
+};
+void OccupancyIndex::set(int row, int col, bool occupied){
+	std::uint64_t* words[4] = {
+		&mRows[static_cast<size_t>(row) * mRowWords + col / 64],
+		&mCols[static_cast<size_t>(col) * mColWords + row / 64],
+		&mDiags[static_cast<size_t>(col - row + mHeight - 1) * mColWords + row / 64],
+		&mAntiDiags[static_cast<size_t>(row + col) * mColWords + row / 64]
+	};
+	std::uint64_t masks[4] = {
+		std::uint64_t(1) << (col % 64),
+		std::uint64_t(1) << (row % 64),
+		std::uint64_t(1) << (row % 64),
+		std::uint64_t(1) << (row % 64)
+	};
+	for(int i = 0; i < 4; i++){
+		if(occupied){
+			*words[i] |= masks[i];
+		}else{
+			*words[i] &= ~masks[i];
+		};
+	};
+};
+bool OccupancyIndex::test(int row, int col) const{
+	return (mRows[static_cast<size_t>(row) * mRowWords + col / 64] >> (col % 64)) & 1;
+};
+bool OccupancyIndex::lineFor(int row, int col, int stepR, int stepC, Line& line) const{
+	line.row = row;
+	line.col = col;
+	if(stepR == 0){
+		// a row: bits over columns
+		if(row < 0 || row >= mHeight) return false;
+		line.bits = &mRows[static_cast<size_t>(row) * mRowWords];
+		line.base = col;
+		line.dir = stepC;
+		line.limit = mWidth;
+		return true;
+	};
+
+	// columns and diagonals are indexed by row
+	line.base = row;
+	line.dir = stepR;
+	line.limit = mHeight;
+	if(stepC == 0){
+		if(col < 0 || col >= mWidth) return false;
+		line.bits = &mCols[static_cast<size_t>(col) * mColWords];
+	}else if(stepC == stepR){
+		int diagonal = col - row + mHeight - 1;
+		if(diagonal < 0 || diagonal >= mHeight + mWidth - 1) return false;
+		line.bits = &mDiags[static_cast<size_t>(diagonal) * mColWords];
+	}else{
+		int diagonal = row + col;
+		if(diagonal < 0 || diagonal >= mHeight + mWidth - 1) return false;
+		line.bits = &mAntiDiags[static_cast<size_t>(diagonal) * mColWords];
+	};
+	return true;
+};
+int OccupancyIndex::nextStep(const Line& line, int fromStep, int lastStep) const{
+	if(fromStep > lastStep){
+		return kNone;
+	};
+	if(line.dir > 0){
+		int low = std::max(line.base + fromStep, 0);
+		int high = std::min(line.base + lastStep, line.limit - 1);
+		int bit = (low <= high) ? nextSet(line.bits, low, high) : -1;
+		return bit < 0 ? kNone : bit - line.base;
+	};
+	int low = std::max(line.base - lastStep, 0);
+	int high = std::min(line.base - fromStep, line.limit - 1);
+	int bit = (low <= high) ? prevSet(line.bits, low, high) : -1;
+	return bit < 0 ? kNone : line.base - bit;
+};
+int OccupancyIndex::nextSet(const std::uint64_t* bits, int low, int high){
+	int word = low / 64;
+	int lastWord = high / 64;
+	std::uint64_t current = bits[word] & (~std::uint64_t(0) << (low % 64));
+	while(true){
+		if(current){
+			int bit = word * 64 + std::countr_zero(current);
+			return bit <= high ? bit : -1;
+		};
+		if(++word > lastWord){
+			return -1;
+		};
+		current = bits[word];
+	};
+};
+int OccupancyIndex::prevSet(const std::uint64_t* bits, int low, int high){
+	int word = high / 64;
+	int firstWord = low / 64;
+	std::uint64_t current = bits[word] & (~std::uint64_t(0) >> (63 - high % 64));
+	while(true){
+		if(current){
+			int bit = word * 64 + 63 - std::countl_zero(current);
+			return bit >= low ? bit : -1;
+		};
+		if(--word < firstWord){
+			return -1;
+		};
+		current = bits[word];
+	};
+};
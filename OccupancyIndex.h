@@ -0,0 +1,89 @@
+#ifndef _OCCUPANCYINDEX_H_
+#define _OCCUPANCYINDEX_H_
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+// Bitsets of which arena cells are non-empty, kept per row, per column,
+// per diagonal (col - row constant) and per anti-diagonal (row + col
+// constant). Walking a straight ray can then jump from one occupied cell
+// to the next instead of visiting every empty '.' in between.
+class OccupancyIndex {
+	public:
+		void reset(int height, int width);
+		void set(int row, int col, bool occupied);
+		bool test(int row, int col) const;
+
+		// Calls visit(row, col) for each occupied cell of the ray leaving
+		// (row, col) in direction (stepR, stepC), one of the 8 compass
+		// directions. The ray advances while its centre is on the board and
+		// is halfWidth cells wide on each side; cells come out in the same
+		// order as Arena::radarPath (by step, then -1, 0, +1 across).
+		template <typename Visit>
+		void forEachOnRay(int row, int col, int stepR, int stepC, int halfWidth, Visit&& visit) const;
+	private:
+		// one straight line of the board, addressed by step number k
+		struct Line {
+			const std::uint64_t* bits;
+			int base;      // bit index of step 0
+			int dir;       // +1 or -1 bit index per step
+			int limit;     // bits in the line
+			int row, col;  // cell at step 0
+			int next;      // next occupied step, or kNone
+		};
+		static const int kNone = 1 << 30;
+		bool lineFor(int row, int col, int stepR, int stepC, Line& line) const;
+		int nextStep(const Line& line, int fromStep, int lastStep) const;
+		// lowest / highest set bit in [low, high], or -1
+		static int nextSet(const std::uint64_t* bits, int low, int high);
+		static int prevSet(const std::uint64_t* bits, int low, int high);
+
+		int mHeight = 0;
+		int mWidth = 0;
+		int mRowWords = 0;   // words per row line (bits over columns)
+		int mColWords = 0;   // words per column / diagonal line (bits over rows)
+		std::vector<std::uint64_t> mRows;
+		std::vector<std::uint64_t> mCols;
+		std::vector<std::uint64_t> mDiags;
+		std::vector<std::uint64_t> mAntiDiags;
+};
+
+template <typename Visit>
+void OccupancyIndex::forEachOnRay(int row, int col, int stepR, int stepC, int halfWidth, Visit&& visit) const{
+	// last step whose centre is still on the board
+	int lastStep = kNone;
+	if(stepR > 0) lastStep = std::min(lastStep, mHeight - 1 - row);
+	if(stepR < 0) lastStep = std::min(lastStep, row);
+	if(stepC > 0) lastStep = std::min(lastStep, mWidth - 1 - col);
+	if(stepC < 0) lastStep = std::min(lastStep, col);
+	if(lastStep == kNone || lastStep < 1){
+		return;
+	};
+
+	// the strip lines, offset along the perpendicular (-stepC, stepR)
+	Line lines[3];
+	int count = 0;
+	for(int w = -halfWidth; w <= halfWidth && count < 3; w++){
+		Line& line = lines[count];
+		if(lineFor(row - stepC * w, col + stepR * w, stepR, stepC, line)){
+			line.next = nextStep(line, 1, lastStep);
+			count++;
+		};
+	};
+
+	// ---- MERGE THE LINES BY STEP; TIES GO TO THE LOWER OFFSET ----
+	while(true){
+		Line* best = nullptr;
+		for(int i = 0; i < count; i++){
+			if(lines[i].next != kNone && (!best || lines[i].next < best->next)){
+				best = &lines[i];
+			};
+		};
+		if(!best){
+			return;
+		};
+		int k = best->next;
+		visit(best->row + k * stepR, best->col + k * stepC);
+		best->next = nextStep(*best, k + 1, lastStep);
+	};
+};
+#endif
@@ -0,0 +1,368 @@
+#include "ReplayLog.h"
+#include <algorithm>
+// events are collected here and written this many bytes at a time
+static const size_t kFlushSize = 1 << 16;
+static const char kHeaderMagic[] = "RWZREPL1";
+static const char kIndexMagic[] = "RWZINDX1";
+// bytes per cell on disk: type, terrain, robot
+static const int kCellSize = 6;
+
+ReplayWriter::ReplayWriter():
+	mWritten(0),
+	mSinceKeyframe(0),
+	mKeyframeSize(0),
+	mClosed(true),
+	mFailed(false){
+	mBuffer.reserve(kFlushSize + 4096);
+};
+ReplayWriter::~ReplayWriter(){
+	close(0);
+};
+bool ReplayWriter::open(const std::string& path){
+	mOut.open(path, std::ios::binary | std::ios::trunc);
+	mClosed = !mOut;
+	return !mClosed;
+};
+void ReplayWriter::putU16(std::uint16_t value){
+	putU8(static_cast<std::uint8_t>(value));
+	putU8(static_cast<std::uint8_t>(value >> 8));
+};
+void ReplayWriter::putU32(std::uint32_t value){
+	for(int shift = 0; shift < 32; shift += 8){
+		putU8(static_cast<std::uint8_t>(value >> shift));
+	};
+};
+void ReplayWriter::putU64(std::uint64_t value){
+	for(int shift = 0; shift < 64; shift += 8){
+		putU8(static_cast<std::uint8_t>(value >> shift));
+	};
+};
+void ReplayWriter::putString(const std::string& text){
+	size_t length = text.size() < 255 ? text.size() : 255;
+	putU8(static_cast<std::uint8_t>(length));
+	mBuffer.insert(mBuffer.end(), text.begin(), text.begin() + length);
+};
+void ReplayWriter::putCells(const std::vector<Cell>& cells){
+	for(const Cell& cell : cells){
+		putU8(static_cast<std::uint8_t>(cell.type));
+		putU8(static_cast<std::uint8_t>(cell.terrain));
+		putI32(cell.robot);
+		flushIfFull();
+	};
+};
+void ReplayWriter::writeHeader(std::uint64_t seed, int height, int width,
+	const std::vector<std::string>& robotIds,
+	const std::vector<std::string>& robotNames,
+	const std::vector<int>& health,
+	const std::vector<Cell>& cells){
+	mBuffer.insert(mBuffer.end(), kHeaderMagic, kHeaderMagic + 8);
+	putU64(seed);
+	putI32(height);
+	putI32(width);
+	putI32(static_cast<std::int32_t>(robotIds.size()));
+	for(size_t i = 0; i < robotIds.size(); i++){
+		putString(robotIds[i]);
+		putString(robotNames[i]);
+		putI32(health[i]);
+	};
+	putCells(cells);
+
+	mKeyframeSize = static_cast<std::uint64_t>(cells.size()) * kCellSize + health.size() * 4;
+	mSinceKeyframe = 0;
+};
+void ReplayWriter::event(ReplayEvent kind, int arg, int robot, int x, int y){
+	putU8(kind);
+	putU8(static_cast<std::uint8_t>(arg));
+	putU16(robot < 0 ? kReplayNoRobot : static_cast<std::uint16_t>(robot));
+	putI32(x);
+	putI32(y);
+	mSinceKeyframe += kReplayEventSize;
+	flushIfFull();
+};
+void ReplayWriter::keyframe(int round, const std::vector<Cell>& cells, const std::vector<int>& health){
+	mIndex.push_back({round, position()});
+	event(ReplayKeyframe, 0, -1, round, 0);
+	putCells(cells);
+	for(int value : health){
+		putI32(value);
+	};
+	mSinceKeyframe = 0;
+	flushIfFull();
+};
+bool ReplayWriter::close(int rounds){
+	if(mClosed){
+		return !mFailed;
+	};
+	event(ReplayEnd, 0, -1, rounds, 0);
+
+	// ---- KEYFRAME INDEX, FOUND FROM THE END OF THE FILE ----
+	std::uint64_t indexOffset = position();
+	putU32(static_cast<std::uint32_t>(mIndex.size()));
+	for(const auto& [round, offset] : mIndex){
+		putI32(round);
+		putU64(offset);
+	};
+	putU64(indexOffset);
+	mBuffer.insert(mBuffer.end(), kIndexMagic, kIndexMagic + 8);
+
+	flush();
+	mOut.close();
+	if(mOut.fail()){
+		mFailed = true;
+	};
+	mClosed = true;
+	return !mFailed;
+};
+void ReplayWriter::flushIfFull(){
+	if(mBuffer.size() >= kFlushSize){
+		flush();
+	};
+};
+void ReplayWriter::flush(){
+	if(!mOut.write(mBuffer.data(), static_cast<std::streamsize>(mBuffer.size()))){
+		mFailed = true;
+	};
+	mWritten += mBuffer.size();
+	mBuffer.clear();
+};
+ReplayReader::ReplayReader():
+	mSeed(0),
+	mHeight(0),
+	mWidth(0),
+	mRounds(-1),
+	mRound(0),
+	mCorrupt(false),
+	mEventsOffset(0){
+};
+bool ReplayReader::readBytes(char* data, size_t size){
+	return static_cast<bool>(mIn.read(data, static_cast<std::streamsize>(size)));
+};
+bool ReplayReader::readU8(std::uint8_t& value){
+	char byte;
+	if(!readBytes(&byte, 1)){
+		return false;
+	};
+	value = static_cast<std::uint8_t>(byte);
+	return true;
+};
+bool ReplayReader::readU32(std::uint32_t& value){
+	unsigned char bytes[4];
+	if(!readBytes(reinterpret_cast<char*>(bytes), 4)){
+		return false;
+	};
+	value = 0;
+	for(int i = 3; i >= 0; i--){
+		value = (value << 8) | bytes[i];
+	};
+	return true;
+};
+bool ReplayReader::readI32(std::int32_t& value){
+	std::uint32_t bits;
+	if(!readU32(bits)){
+		return false;
+	};
+	value = static_cast<std::int32_t>(bits);
+	return true;
+};
+bool ReplayReader::readU64(std::uint64_t& value){
+	std::uint32_t low, high;
+	if(!readU32(low) || !readU32(high)){
+		return false;
+	};
+	value = (static_cast<std::uint64_t>(high) << 32) | low;
+	return true;
+};
+bool ReplayReader::readString(std::string& text){
+	std::uint8_t length;
+	if(!readU8(length)){
+		return false;
+	};
+	text.resize(length);
+	return length == 0 || readBytes(text.data(), length);
+};
+bool ReplayReader::readBoard(){
+	std::vector<char> bytes(mCells.size() * kCellSize);
+	if(!readBytes(bytes.data(), bytes.size())){
+		return false;
+	};
+	for(size_t i = 0; i < mCells.size(); i++){
+		const unsigned char* cell = reinterpret_cast<const unsigned char*>(&bytes[i * kCellSize]);
+		std::uint32_t robot = cell[2] | (cell[3] << 8) | (cell[4] << 16) | (static_cast<std::uint32_t>(cell[5]) << 24);
+		mCells[i] = Cell{static_cast<char>(cell[0]), static_cast<char>(cell[1]), static_cast<int>(robot)};
+		if(!knownRobot(mCells[i].type, mCells[i].robot)){
+			mCorrupt = true;
+			return false;
+		};
+	};
+	return true;
+};
+bool ReplayReader::knownRobot(char type, int robot) const{
+	if(type != 'R' && type != 'X'){
+		return true;
+	};
+	return robot >= 0 && robot < static_cast<int>(mRobots.size());
+};
+bool ReplayReader::open(const std::string& path, std::string& error){
+	mIn.open(path, std::ios::binary);
+	if(!mIn){
+		error = "cannot open replay " + path;
+		return false;
+	};
+
+	// ---- HEADER ----
+	char magic[8];
+	std::int32_t height, width, count;
+	if(!readBytes(magic, 8) || !std::equal(magic, magic + 8, kHeaderMagic) ||
+		!readU64(mSeed) || !readI32(height) || !readI32(width) || !readI32(count) ||
+		height <= 0 || width <= 0 || count < 0){
+		error = path + " is not a RobotWarz replay";
+		return false;
+	};
+	mHeight = height;
+	mWidth = width;
+	mRobots.resize(count);
+	for(ReplayRobot& robot : mRobots){
+		std::int32_t health;
+		if(!readString(robot.id) || !readString(robot.name) || !readI32(health)){
+			error = path + " has a truncated header";
+			return false;
+		};
+		robot.health = health;
+	};
+	mCells.resize(static_cast<size_t>(height) * width);
+	if(!readBoard()){
+		error = path + (mCorrupt ? " has a robot on the board that is not in the header"
+		                         : " has a truncated header");
+		return false;
+	};
+	mStartCells = mCells;
+	for(const ReplayRobot& robot : mRobots){
+		mStartHealth.push_back(robot.health);
+	};
+	mEventsOffset = static_cast<std::uint64_t>(mIn.tellg());
+
+	// ---- KEYFRAME INDEX AND ROUND COUNT FROM THE END ----
+	mIn.seekg(-16, std::ios::end);
+	std::uint64_t indexOffset;
+	if(readU64(indexOffset) && readBytes(magic, 8) && std::equal(magic, magic + 8, kIndexMagic)){
+		mIn.seekg(static_cast<std::streamoff>(indexOffset));
+		std::uint32_t entries;
+		if(readU32(entries)){
+			for(std::uint32_t i = 0; i < entries; i++){
+				std::int32_t round;
+				std::uint64_t offset;
+				if(!readI32(round) || !readU64(offset)){
+					break;
+				};
+				mIndex.push_back({round, offset});
+			};
+		};
+		// the end event sits just before the index
+		mIn.clear();
+		mIn.seekg(static_cast<std::streamoff>(indexOffset - kReplayEventSize));
+		ReplayRecord end{};
+		next(end);
+		if(end.kind == ReplayEnd){
+			mRounds = end.x;
+		};
+	};
+	restart();
+	return true;
+};
+void ReplayReader::restart(){
+	mIn.clear();
+	mIn.seekg(static_cast<std::streamoff>(mEventsOffset));
+	mCells = mStartCells;
+	for(size_t i = 0; i < mRobots.size(); i++){
+		mRobots[i].health = mStartHealth[i];
+	};
+	mRound = 0;
+};
+void ReplayReader::seek(int round){
+	// ---- JUMP TO THE LAST KEYFRAME AT OR BEFORE THE ROUND ----
+	auto after = std::upper_bound(mIndex.begin(), mIndex.end(), std::make_pair(round, UINT64_MAX));
+	bool backwards = round < mRound;
+	bool fromKeyframe = false;
+	if(after != mIndex.begin() && (backwards || (after - 1)->first > mRound)){
+		mIn.clear();
+		mIn.seekg(static_cast<std::streamoff>((after - 1)->second));
+		ReplayRecord record;
+		fromKeyframe = next(record) && record.kind == ReplayKeyframe;
+	};
+	if(!fromKeyframe && backwards){
+		restart();
+	};
+
+	// ---- THEN EVENT BY EVENT UP TO THE ROUND'S START ----
+	while(mRound < round){
+		std::streampos before = mIn.tellg();
+		ReplayRecord record;
+		if(!next(record)){
+			return;
+		};
+		if(record.kind == ReplayRound && record.x >= round){
+			// leave the round marker for whoever reads on
+			mIn.seekg(before);
+			mRound = record.x;
+			return;
+		};
+	};
+};
+bool ReplayReader::next(ReplayRecord& record){
+	unsigned char bytes[kReplayEventSize];
+	if(!readBytes(reinterpret_cast<char*>(bytes), kReplayEventSize)){
+		return false;
+	};
+	auto i32 = [&](int at){
+		std::uint32_t bits = bytes[at] | (bytes[at + 1] << 8) | (bytes[at + 2] << 16) |
+			(static_cast<std::uint32_t>(bytes[at + 3]) << 24);
+		return static_cast<int>(bits);
+	};
+	std::uint16_t robot = static_cast<std::uint16_t>(bytes[2] | (bytes[3] << 8));
+	record.kind = static_cast<ReplayEvent>(bytes[0]);
+	record.arg = bytes[1];
+	record.robot = robot == kReplayNoRobot ? -1 : robot;
+	record.x = i32(4);
+	record.y = i32(8);
+
+	// ---- APPLY IT ----
+	switch(record.kind){
+		case ReplayRound:
+			mRound = record.x;
+			break;
+		case ReplayCell:
+			if(!knownRobot(static_cast<char>(record.arg), record.robot)){
+				mCorrupt = true;
+				return false;
+			};
+			if(record.x >= 0 && record.x < mHeight && record.y >= 0 && record.y < mWidth){
+				Cell& cell = mCells[static_cast<size_t>(record.x) * mWidth + record.y];
+				cell.type = static_cast<char>(record.arg);
+				cell.robot = record.robot;
+			};
+			break;
+		case ReplayDamage:
+			if(record.robot >= 0 && record.robot < static_cast<int>(mRobots.size())){
+				mRobots[record.robot].health = record.y;
+			};
+			break;
+		case ReplayKeyframe:
+			if(!readBoard()){
+				return false;
+			};
+			for(ReplayRobot& robot : mRobots){
+				std::int32_t health;
+				if(!readI32(health)){
+					return false;
+				};
+				robot.health = health;
+			};
+			mRound = record.x;
+			break;
+		case ReplayEnd:
+			return false;   // record still holds the end event
+		default:
+			break;
+	};
+	return true;
+};
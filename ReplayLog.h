@@ -0,0 +1,145 @@
+#ifndef _REPLAYLOG_H_
+#define _REPLAYLOG_H_
+#include "Arena.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+// Binary record of a game, enough to rebuild the board at every step
+// without the robots. Everything is little-endian.
+//
+// Header: "RWZREPL1", u64 seed, i32 height, i32 width, i32 robot count,
+// then per robot a u8-length-prefixed token, a u8-length-prefixed name
+// and i32 starting health, then the starting board as height * width
+// cells of (u8 type, u8 terrain, i32 robot).
+//
+// Then a stream of fixed 12-byte events: u8 kind, u8 arg, u16 robot
+// (0xFFFF = none), i32 x, i32 y. See ReplayEvent for what each carries.
+// A keyframe event is followed by the whole board (as in the header) and
+// i32 health per robot. One is written at the start of a round once the
+// events since the previous one outweigh it, so keyframes at most double
+// the log and a seek replays at most a keyframe's worth of events.
+//
+// After the end event comes the keyframe index: u32 count, then
+// (i32 round, u64 file offset of the keyframe event) pairs, then u64
+// offset of the index and "RWZINDX1". A log cut short has no index and
+// is read from the start.
+enum ReplayEvent : std::uint8_t {
+	ReplayRound = 1,    // x = round number, before anyone acts
+	ReplayTurn,         // robot starts its turn; arg = radar direction
+	ReplayForfeit,      // robot missed the callback deadline
+	ReplayShot,         // arg = weapon, x/y = target
+	ReplayMove,         // arg = direction, x = distance
+	ReplayDamage,       // robot hit for x damage, y = health after
+	ReplayCell,         // cell x/y now shows arg ('R', '.', ...) of robot
+	ReplayEnd,          // x = rounds played
+	ReplayKeyframe      // x = round; board and health follow
+};
+const std::uint16_t kReplayNoRobot = 0xFFFF;
+// robot indexes are u16 and 0xFFFF means none, so 0 ... 65534 fit
+const int kReplayMaxRobots = kReplayNoRobot;
+const int kReplayEventSize = 12;
+class ReplayWriter {
+	public:
+		ReplayWriter();
+		~ReplayWriter();
+		ReplayWriter(const ReplayWriter&) = delete;
+		ReplayWriter& operator=(const ReplayWriter&) = delete;
+		// false if the file cannot be created
+		bool open(const std::string& path);
+		void writeHeader(std::uint64_t seed, int height, int width,
+			const std::vector<std::string>& robotIds,
+			const std::vector<std::string>& robotNames,
+			const std::vector<int>& health,
+			const std::vector<Cell>& cells);
+		void event(ReplayEvent kind, int arg, int robot, int x, int y);
+		bool keyframeDue() const { return mSinceKeyframe >= mKeyframeSize; }
+		void keyframe(int round, const std::vector<Cell>& cells, const std::vector<int>& health);
+		// Writes the end marker and index and flushes; safe to call twice.
+		// False if anything written since open() failed to reach the file.
+		bool close(int rounds);
+	private:
+		void putU8(std::uint8_t value) { mBuffer.push_back(static_cast<char>(value)); }
+		void putU16(std::uint16_t value);
+		void putU32(std::uint32_t value);
+		void putI32(std::int32_t value) { putU32(static_cast<std::uint32_t>(value)); }
+		void putU64(std::uint64_t value);
+		void putString(const std::string& text);
+		void putCells(const std::vector<Cell>& cells);
+		std::uint64_t position() const { return mWritten + mBuffer.size(); }
+		void flushIfFull();
+		void flush();
+		std::ofstream mOut;
+		std::vector<char> mBuffer;
+		std::uint64_t mWritten;        // bytes already in the file
+		std::uint64_t mSinceKeyframe;  // event bytes since the last board
+		std::uint64_t mKeyframeSize;
+		std::vector<std::pair<int, std::uint64_t>> mIndex;   // round, offset
+		bool mClosed;
+		bool mFailed;   // a write failed, e.g. on a full disk
+};
+struct ReplayRobot {
+	std::string id;
+	std::string name;
+	int health;
+};
+struct ReplayRecord {
+	ReplayEvent kind;
+	int arg;
+	int robot;   // -1 = none
+	int x;
+	int y;
+};
+// Reads a replay log and keeps the board and robot health current as it
+// steps through the events.
+class ReplayReader {
+	public:
+		ReplayReader();
+		// reads the header and index; false with error filled on failure
+		bool open(const std::string& path, std::string& error);
+		// Moves to the start of round (before anyone acts), from the
+		// nearest keyframe. Past the end of the game it stops at the end.
+		void seek(int round);
+		// Reads and applies the next event; false once the log ends or
+		// turns out to be corrupt.
+		bool next(ReplayRecord& record);
+		// a board or event named a robot the header does not list
+		bool corrupt() const { return mCorrupt; }
+		int height() const { return mHeight; }
+		int width() const { return mWidth; }
+		std::uint64_t seed() const { return mSeed; }
+		// rounds played, or -1 if the log has no end marker yet
+		int rounds() const { return mRounds; }
+		const std::vector<ReplayRobot>& robots() const { return mRobots; }
+		const std::vector<Cell>& cells() const { return mCells; }
+		// the current round (0 before the first)
+		int round() const { return mRound; }
+	private:
+		bool readBytes(char* data, size_t size);
+		bool readU8(std::uint8_t& value);
+		bool readU32(std::uint32_t& value);
+		bool readI32(std::int32_t& value);
+		bool readU64(std::uint64_t& value);
+		bool readString(std::string& text);
+		bool readBoard();
+		// robot cells must name one of the header's robots
+		bool knownRobot(char type, int robot) const;
+		void restart();
+		std::ifstream mIn;
+		std::uint64_t mSeed;
+		int mHeight;
+		int mWidth;
+		int mRounds;
+		int mRound;
+		bool mCorrupt;
+		std::vector<ReplayRobot> mRobots;
+		std::vector<Cell> mCells;
+		// starting state and where the events begin, for seeks before
+		// the first keyframe
+		std::vector<Cell> mStartCells;
+		std::vector<int> mStartHealth;
+		std::uint64_t mEventsOffset;
+		std::vector<std::pair<int, std::uint64_t>> mIndex;
+};
+#endif
@@ -0,0 +1,107 @@
+#include "ReplayPlayer.h"
+#include "Arena.h"
+#include "ReplayLog.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+// An arena that never runs robots: replayed boards are loaded into it so
+// they print exactly like a live game. ReplayReader rejects robot cells
+// that name a robot outside the header, so every one printed has a token.
+class ReplayArena : public Arena {
+	public:
+		ReplayArena(int height, int width, const std::vector<ReplayRobot>& robots):
+			Arena(height, width, {}, 0){
+			for(const ReplayRobot& robot : robots){
+				mRobotIds.push_back(robot.id);
+				mRobotIdWidth = std::max(mRobotIdWidth, static_cast<int>(robot.id.size()));
+			};
+		}
+		void load(const std::vector<Cell>& cells){
+			for(int row = 0; row < mHeight; row++){
+				for(int col = 0; col < mWidth; col++){
+					setCell(row, col, cells[static_cast<size_t>(row) * mWidth + col]);
+				};
+			};
+		}
+};
+static void printRound(ReplayArena& arena, const ReplayReader& replay, const char* title, int round){
+	std::cout << "=========== " << title;
+	if(round >= 0){
+		std::cout << " " << round;
+	};
+	std::cout << " ===========\n\n";
+
+	arena.load(replay.cells());
+	arena.printState(std::cout);
+	std::cout << "\n";
+	for(const ReplayRobot& robot : replay.robots()){
+		std::cout << robot.id << " " << robot.name << " health: " << robot.health;
+		if(robot.health <= 0){
+			std::cout << " - is out";
+		};
+		std::cout << "\n";
+	};
+	std::cout << "\n";
+};
+int playReplay(const std::string& path, int round, int tickRate){
+	ReplayReader replay;
+	std::string error;
+	if(!replay.open(path, error)){
+		std::cerr << "ERROR: " << error << "\n";
+		return 1;
+	};
+
+	std::cout << "Replay: " << path << "  seed: " << replay.seed()
+	          << "  rounds: ";
+	if(replay.rounds() >= 0){
+		std::cout << replay.rounds() << "\n\n";
+	}else{
+		std::cout << "unfinished\n\n";
+	};
+
+	ReplayArena arena(replay.height(), replay.width(), replay.robots());
+
+	// ---- ONE ROUND ----
+	if(round > 0){
+		replay.seek(round);
+		if(replay.corrupt()){
+			std::cerr << "ERROR: " << path << " is corrupt after round " << replay.round() << "\n";
+			return 1;
+		};
+		if(replay.round() < round){
+			printRound(arena, replay, "game over after round", replay.round());
+		}else{
+			printRound(arena, replay, "starting round", round);
+		};
+		return 0;
+	};
+
+	// ---- THE WHOLE GAME ----
+	using Clock = std::chrono::steady_clock;
+	Clock::duration frameTime = Clock::duration::zero();
+	if(tickRate > 0){
+		frameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / tickRate;
+	};
+	Clock::time_point nextFrame = Clock::now();
+
+	ReplayRecord record;
+	while(replay.next(record)){
+		if(record.kind != ReplayRound){
+			continue;
+		};
+		// the round has started but nobody has acted yet
+		printRound(arena, replay, "starting round", record.x);
+		if(tickRate > 0){
+			nextFrame += frameTime;
+			std::this_thread::sleep_until(nextFrame);
+		};
+	};
+	if(replay.corrupt()){
+		std::cerr << "ERROR: " << path << " is corrupt after round " << replay.round() << "\n";
+		return 1;
+	};
+	printRound(arena, replay, "game over", -1);
+	return 0;
+};
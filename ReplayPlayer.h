@@ -0,0 +1,10 @@
+#ifndef _REPLAYPLAYER_H_
+#define _REPLAYPLAYER_H_
+#include <string>
+// Prints a recorded game (see ReplayLog.h) the way watch_live does,
+// without loading any robots. round > 0 prints just the board at the
+// start of that round, jumping there from the nearest keyframe; otherwise
+// every round is printed at tickRate rounds per second (0 = unlimited).
+// Returns the process exit code.
+int playReplay(const std::string& path, int round, int tickRate);
+#endif
@@ -0,0 +1,111 @@
+#include "RobotRunner.h"
+RobotRunner::RobotRunner(RobotBase* robot, std::chrono::microseconds budget):
+	mShared(std::make_shared<Shared>()),
+	mBudget(budget),
+	mOverruns(0),
+	mHealthAtCall(robot ? robot->get_health() : 0){
+	mShared->robot = robot;
+	mThread = std::thread(&RobotRunner::workerLoop, mShared);
+};
+RobotRunner::~RobotRunner(){
+	bool stuck;
+	{
+		std::lock_guard<std::mutex> lock(mShared->mutex);
+		mShared->stopping = true;
+		stuck = mShared->pending;
+	}
+	mShared->wake.notify_one();
+	if(stuck){
+		// waiting could take forever; the worker exits once the call returns
+		mThread.detach();
+	}else{
+		mThread.join();
+	};
+};
+bool RobotRunner::busy() const{
+	std::lock_guard<std::mutex> lock(mShared->mutex);
+	return mShared->pending;
+};
+bool RobotRunner::run(Call call){
+	std::unique_lock<std::mutex> lock(mShared->mutex);
+	if(mShared->pending){
+		return false;   // still inside a call that overran earlier
+	};
+	mHealthAtCall = mShared->robot->get_health();
+	mShared->call = call;
+	mShared->pending = true;
+	mShared->wake.notify_one();
+
+	if(!mShared->done.wait_for(lock, mBudget, [this]{ return !mShared->pending; })){
+		mOverruns++;
+		return false;
+	};
+	return true;
+};
+bool RobotRunner::radarDirection(int& direction){
+	if(!run(RadarDirection)){
+		return false;
+	};
+	direction = mShared->direction;
+	return true;
+};
+bool RobotRunner::processRadar(const std::vector<RadarObj>& results){
+	{
+		// the worker may still be reading the last copy
+		std::lock_guard<std::mutex> lock(mShared->mutex);
+		if(mShared->pending){
+			return false;
+		};
+		mShared->radarInput = results;
+	}
+	return run(ProcessRadar);
+};
+bool RobotRunner::shotLocation(bool& shoots, int& row, int& col){
+	if(!run(ShotLocation)){
+		return false;
+	};
+	shoots = mShared->shoots;
+	row = mShared->row;
+	col = mShared->col;
+	return true;
+};
+bool RobotRunner::moveDirection(int& direction, int& distance){
+	if(!run(MoveDirection)){
+		return false;
+	};
+	direction = mShared->direction;
+	distance = mShared->distance;
+	return true;
+};
+void RobotRunner::workerLoop(std::shared_ptr<Shared> shared){
+	std::unique_lock<std::mutex> lock(shared->mutex);
+	while(true){
+		shared->wake.wait(lock, [&]{ return shared->stopping || shared->pending; });
+		if(!shared->pending){
+			return;   // stopping with nothing left to run
+		};
+
+		// ---- RUN THE CALL WITHOUT HOLDING THE LOCK ----
+		Call call = shared->call;
+		RobotBase* robot = shared->robot;
+		lock.unlock();
+		switch(call){
+			case RadarDirection:
+				robot->get_radar_direction(shared->direction);
+				break;
+			case ProcessRadar:
+				robot->process_radar_results(shared->radarInput);
+				break;
+			case ShotLocation:
+				shared->shoots = robot->get_shot_location(shared->row, shared->col);
+				break;
+			case MoveDirection:
+				robot->get_move_direction(shared->direction, shared->distance);
+				break;
+		};
+		lock.lock();
+
+		shared->pending = false;
+		shared->done.notify_one();
+	};
+};
@@ -0,0 +1,67 @@
+#ifndef _ROBOTRUNNER_H_
+#define _ROBOTRUNNER_H_
+#include "RobotBase.h"
+#include "RadarObj.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// Runs one robot's four decision callbacks on a thread of its own, so the
+// game stops waiting once a call takes longer than the budget. Inputs and
+// outputs live with the worker, never on the caller's stack, because an
+// overrunning call keeps going in the background: the robot counts as
+// busy, and every call returns false, until it comes back.
+class RobotRunner {
+	public:
+		RobotRunner(RobotBase* robot, std::chrono::microseconds budget);
+		// Stops the worker. If the robot is still stuck in a call the
+		// thread is left behind to finish (or never finish) on its own,
+		// and the robot must not be deleted: see busy().
+		~RobotRunner();
+		RobotRunner(const RobotRunner&) = delete;
+		RobotRunner& operator=(const RobotRunner&) = delete;
+		// Each returns false if the robot was still busy or missed the
+		// deadline; the outputs are only set on true.
+		bool radarDirection(int& direction);
+		bool processRadar(const std::vector<RadarObj>& results);
+		bool shotLocation(bool& shoots, int& row, int& col);
+		bool moveDirection(int& direction, int& distance);
+		// calls that missed the deadline so far
+		int overruns() const { return mOverruns; }
+		// A call that overran is still running on the robot's thread, so
+		// nothing else may touch the robot until it returns.
+		bool busy() const;
+		// The robot's health when the last call was posted. A busy robot
+		// takes no damage, so this stays its health until it returns.
+		int healthAtCall() const { return mHealthAtCall; }
+	private:
+		enum Call { RadarDirection, ProcessRadar, ShotLocation, MoveDirection };
+		// What the worker uses. It keeps its own reference, so a runner
+		// can go away while the worker is still inside a call.
+		struct Shared {
+			RobotBase* robot;
+			std::mutex mutex;
+			std::condition_variable wake;
+			std::condition_variable done;
+			Call call = RadarDirection;
+			bool pending = false;    // a call is posted or still running
+			bool stopping = false;
+			// owned by the worker while pending is set
+			std::vector<RadarObj> radarInput;
+			int direction = 0;
+			int distance = 0;
+			int row = 0;
+			int col = 0;
+			bool shoots = false;
+		};
+		bool run(Call call);
+		static void workerLoop(std::shared_ptr<Shared> shared);
+		std::shared_ptr<Shared> mShared;
+		std::chrono::microseconds mBudget;
+		int mOverruns;
+		int mHealthAtCall;
+		std::thread mThread;
+};
+#endif
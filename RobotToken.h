@@ -0,0 +1,19 @@
+#ifndef _ROBOTTOKEN_H_
+#define _ROBOTTOKEN_H_
+#include <string>
+// Grid token of the n-th robot: "R@" ... "R?", then "R@1" ... "R?1", "R@2",
+// ... The symbol after the 'R' is also the robot's m_character. Shared by
+// the game and the tools that build arenas of their own.
+inline std::string robotToken(int n){
+	// Characters used after 'R' for unique robot IDs
+	static const std::string symbols = "@#$%&!*+=<>?";
+	const int count = static_cast<int>(symbols.size());
+
+	std::string token = "R";
+	token += symbols[n % count];
+	if(n >= count){
+		token += std::to_string(n / count);
+	};
+	return token;
+}
+#endif
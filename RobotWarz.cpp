@@ -1,7 +1,49 @@
 #include "RobotWarz_aux.h"
+#include "ReplayPlayer.h"
+#include <iostream>
+#include <string>
 
-int main()
+static void printUsage()
 {
-    runInteractiveGame();
+    std::cerr << "usage: RobotWarz [--config <file>] [--<setting> <value>]...\n"
+              << "                 [--tournament <games> [--threads <n>]] [--rebuild]\n"
+              << "settings: height width obstacles pits mounds flamethrowers\n"
+              << "          max_rounds watch_live tick_rate seed robot_dir instances\n"
+              << "          simultaneous_radar deadline_us profile record\n"
+              << "       RobotWarz --replay <file> [--round <n>] [--tick-rate <n>]\n"
+              << "With no config or settings the game is set up interactively.\n";
+}
+
+int main(int argc, char* argv[])
+{
+    CommandLine command;
+    std::string error;
+    if (!parseCommandLine(argc, argv, command, error))
+    {
+        if (!error.empty())
+            std::cerr << "ERROR: " << error << "\n";
+        if (command.showUsage)
+            printUsage();
+        return 1;
+    }
+    TournamentSetup& tournament = command.tournament;
+
+    // ---- REPLAYS NEED NO ROBOTS ----
+    if (!command.replayPath.empty())
+        return playReplay(command.replayPath, command.replayRound, tournament.game.tickRate);
+
+    if ((command.configured || tournament.numGames > 0) &&
+        !validateGameSetup(tournament.game, error))
+    {
+        std::cerr << "ERROR: " << error << "\n";
+        return 1;
+    }
+
+    if (tournament.numGames > 0)
+        runTournament(tournament);
+    else if (command.configured)
+        runSingleGame(tournament.game, tournament.forceRebuild);
+    else
+        runInteractiveGame(tournament.forceRebuild);
     return 0;
 }
@@ -4,8 +4,18 @@
 #include <thread>
 #include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <cstdlib>
 #include <dlfcn.h>
+#include <unistd.h>
+#include "LiveView.h"
+#include "RobotToken.h"
+#include <algorithm>
+#include <random>
+#include <memory>
+#include <set>
+#include "ThreadPool.h"
 GameSetup promptGameSetup()
 {
     GameSetup setup;
@@ -46,7 +56,8 @@ GameSetup promptGameSetup()
         }
     }
 
-    int maxCells = setup.height * setup.width;
+    // obstacles only go inside the border
+    int maxCells = (setup.height - 2) * (setup.width - 2);
 
     // ---- NUMBER OF OBSTACLES ----
     while (true)
@@ -54,10 +65,10 @@ GameSetup promptGameSetup()
         std::cout << "Enter number of obstacles: ";
         std::cin >> setup.numObstacles;
 
-        if (std::cin.fail() || setup.numObstacles < 0 || setup.numObstacles >= maxCells)
+        if (std::cin.fail() || setup.numObstacles < 0 || setup.numObstacles > maxCells)
         {
             std::cout << "Invalid obstacle count. Must be between 0 and "
-                      << (maxCells - 1) << ".\n";
+                      << maxCells << ".\n";
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         }
@@ -108,6 +119,17 @@ GameSetup promptGameSetup()
         }
     }
 
+    setup.numPits = 0;
+    setup.numMounds = 0;
+    setup.numFlames = 0;
+    setup.seed = randomSeed();
+    setup.tickRate = 10;
+    setup.robotDirectory = ".";
+    setup.instances = 1;
+    setup.simultaneousRadar = false;
+    setup.deadlineMicros = 0;
+    setup.profile = 0;
+
     return setup;
 }
 
@@ -117,19 +139,41 @@ Arena buildArena(const GameSetup& setup,
     return Arena(setup.height,
                  setup.width,
                  robots,
-                 setup.numObstacles);
+                 setup.numObstacles,
+                 setup.seed,
+                 setup.numPits,
+                 setup.numMounds,
+                 setup.numFlames);
 }
 void runGame(Arena& arena,
              const std::map<std::string, RobotBase*>& robots,
              int maxRounds,
-             bool watchLive)
+             bool watchLive,
+             int tickRate)
 {
     int round = 1;
 
+    // A terminal gets a board redrawn in place; piped output keeps the
+    // plain printState dump every round.
+    bool inPlace = watchLive && isatty(STDOUT_FILENO);
+    LiveView view(STDOUT_FILENO);
+    if (inPlace)
+        std::cout << std::flush;   // the view writes to the fd directly
+
+    using Clock = std::chrono::steady_clock;
+    Clock::duration frameTime = Clock::duration::zero();
+    if (tickRate > 0)
+        frameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / tickRate;
+    Clock::time_point nextFrame = Clock::now();
+
     while (round <= maxRounds && arena.getAlive() > 1)
     {
         // ---- LIVE MODE OUTPUT ----
-        if (watchLive)
+        if (inPlace)
+        {
+            view.draw(arena, round, robots);
+        }
+        else if (watchLive)
         {
             std::cout << "=========== starting round " << round
                       << " ===========\n\n";
@@ -138,11 +182,18 @@ void runGame(Arena& arena,
             std::cout << "\n";
 
             // Print robot stats
+            int index = -1;   // the arena holds the robots in map order
             for (const auto& [name, robot] : robots)
             {
+                index++;
                 if (!robot) continue;
 
-                if (robot->get_health() <= 0)
+                if (arena.isRobotBusy(index))
+                {
+                    // still inside an overrunning call, hands off its stats
+                    std::cout << name << " (busy)\n\n";
+                }
+                else if (robot->get_health() <= 0)
                 {
                     std::cout << robot->print_stats()
                               << " - is out\n\n";
@@ -159,29 +210,111 @@ void runGame(Arena& arena,
         // ---- RUN ONE FULL ROUND ----
         arena.iterate();
 
-        // ---- LIVE MODE DELAY ----
-        if (watchLive)
+        // ---- ROBOTS DESTROYED THIS ROUND ----
+        if (watchLive && !inPlace)
         {
-            std::this_thread::sleep_for(
-                std::chrono::seconds(1));
+            for (int index : arena.getDeaths())
+                std::cout << arena.getRobotId(index) << " destroyed in round "
+                          << round << "\n\n";
+        }
+
+        // ---- LIVE MODE FRAME RATE (tickRate 0 = as fast as possible) ----
+        if (watchLive && tickRate > 0)
+        {
+            nextFrame += frameTime;
+            std::this_thread::sleep_until(nextFrame);
         }
 
         round++;
     }
 
+    // a robot stuck in a call when the game ends is out
+    arena.retireBusyRobots();
+
+    if (inPlace)
+    {
+        view.draw(arena, round, robots);
+        view.finish();
+    }
+
     // ---- ALWAYS PRINT FINAL RESULT ----
     std::cout << "=========== game over ===========\n\n";
     arena.printState(std::cout);
     std::cout << "\nWinner: " << arena.getWinner() << "\n";
+
+    // ---- ROBOTS THAT MISSED THE CALLBACK DEADLINE ----
+    if (arena.hasCallbackDeadline())
+    {
+        std::cout << "\nDeadline overruns:\n";
+        for (int index = 0; index < arena.getRobotCount(); index++)
+            std::cout << arena.getRobotId(index) << ": " << arena.getOverruns(index) << "\n";
+    }
+
+    if (arena.isProfiling())
+    {
+        std::cout << "\n";
+        arena.printProfile(std::cout);
+    }
 }
-std::map<std::string, RobotBase*> loadRobotsFromDirectory(const std::string& directory)
+// Compiler and flags used to build every robot library.
+static const std::string kRobotCompiler = "g++";
+static const std::string kRobotCompileFlags = "-shared -fPIC -I. -std=c++20";
+
+// FNV-1a over a file's bytes, chained onto hash. Missing files hash as empty.
+static std::uint64_t hashFile(const std::string& path, std::uint64_t hash)
 {
-    std::map<std::string, RobotBase*> robots;
+    std::ifstream in(path, std::ios::binary);
+    char buffer[4096];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0)
+    {
+        for (std::streamsize i = 0; i < in.gcount(); i++)
+        {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= 0x100000001B3ULL;
+        }
+    }
+    return hash;
+}
+static std::uint64_t hashString(const std::string& text, std::uint64_t hash)
+{
+    for (char c : text)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+// Build cache key for one robot: its source, the compile command and the
+// RobotBase object (and headers) it is linked against.
+static std::string robotBuildKey(const std::string& source)
+{
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    hash = hashString(kRobotCompiler + " " + kRobotCompileFlags, hash);
+    hash = hashFile(source, hash);
+    hash = hashFile("RobotBase_pic.o", hash);
+    hash = hashFile("RobotBase.h", hash);
+    hash = hashFile("RadarObj.h", hash);
+
+    std::ostringstream key;
+    key << std::hex << hash;
+    return key.str();
+}
+// True when sharedLib exists and was built from the same inputs.
+static bool robotBuildIsCached(const std::string& sharedLib, const std::string& key)
+{
+    if (!std::filesystem::exists(sharedLib))
+        return false;
 
-    // Characters used after 'R' for unique robot IDs
-    const std::string symbols = "@#$%&!*+=<>?";
-    int symbolIndex = 0;
+    std::ifstream in(sharedLib + ".key");
+    std::string cachedKey;
+    return (in >> cachedKey) && cachedKey == key;
+}
+std::vector<LoadedRobot> loadRobotFactories(const std::string& directory, bool forceRebuild)
+{
+    std::vector<LoadedRobot> factories;
 
+    // ---- FIND Robot_*.cpp, SORTED SO "R@", "R#"... ARE STABLE ----
+    std::vector<std::string> sources;
     for (const auto& entry : std::filesystem::directory_iterator(directory))
     {
         std::string filename = entry.path().filename().string();
@@ -190,26 +323,78 @@ std::map<std::string, RobotBase*> loadRobotsFromDirectory(const std::string& dir
         if (filename.rfind("Robot_", 0) != 0 || filename.find(".cpp") == std::string::npos)
             continue;
 
-        // ---- BUILD SHARED LIBRARY NAME ----
-        std::string baseName = filename.substr(0, filename.find(".cpp"));
-        std::string sharedLib = baseName + ".so";
+        sources.push_back(filename);
+    }
+    std::sort(sources.begin(), sources.end());
+
+    // ---- WORK OUT WHICH ROBOTS NEED COMPILING ----
+    // libraries are built next to their source, e.g. ./Robot_Ratboy.so
+    std::vector<std::string> baseNames(sources.size());
+    std::vector<std::string> sourcePaths(sources.size());
+    std::vector<std::string> libPaths(sources.size());
+    std::vector<std::string> buildKeys(sources.size());
+    std::vector<int> toCompile;
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        baseNames[i] = sources[i].substr(0, sources[i].find(".cpp"));
+        sourcePaths[i] = (std::filesystem::path(directory) / sources[i]).string();
+        libPaths[i] = (std::filesystem::path(directory) / (baseNames[i] + ".so")).string();
+        buildKeys[i] = robotBuildKey(sourcePaths[i]);
+
+        std::string sharedLib = baseNames[i] + ".so";
+        if (!forceRebuild && robotBuildIsCached(libPaths[i], buildKeys[i]))
+        {
+            std::cout << "Using cached " << sharedLib << "\n";
+        }
+        else
+        {
+            std::cout << "Compiling " << sources[i] << " -> " << sharedLib << "\n";
+            std::filesystem::remove(libPaths[i] + ".key");
+            toCompile.push_back(static_cast<int>(i));
+        }
+    }
 
-        // ---- COMPILE INTO SHARED OBJECT ----
-        std::string compile_cmd =
-            "g++ -shared -fPIC -o " + sharedLib + " " +
-            filename + " RobotBase_pic.o -I. -std=c++20";
+    // ---- COMPILE CACHE MISSES IN PARALLEL, ONE g++ PER CORE ----
+    std::vector<bool> failed(sources.size(), false);
+    if (!toCompile.empty())
+    {
+        ThreadPool pool;
+        std::vector<int> results(toCompile.size(), 0);
+        pool.parallelFor(static_cast<int>(toCompile.size()), [&](int job)
+        {
+            int i = toCompile[job];
+            std::string compile_cmd =
+                kRobotCompiler + " " + kRobotCompileFlags + " -o " + libPaths[i] + " " +
+                sourcePaths[i] + " RobotBase_pic.o";
 
-        std::cout << "Compiling " << filename << " -> " << sharedLib << "\n";
+            results[job] = std::system(compile_cmd.c_str());
+        });
 
-        int compile_result = std::system(compile_cmd.c_str());
-        if (compile_result != 0)
+        for (size_t job = 0; job < toCompile.size(); job++)
         {
-            std::cerr << "ERROR: Failed to compile " << filename << "\n";
-            continue;
+            int i = toCompile[job];
+            if (results[job] != 0)
+            {
+                std::cerr << "ERROR: Failed to compile " << sources[i] << "\n";
+                failed[i] = true;
+                continue;
+            }
+            std::ofstream(libPaths[i] + ".key") << buildKeys[i] << "\n";
         }
+    }
+
+    // ---- LOAD IN SORTED ORDER ----
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        if (failed[i])
+            continue;
+
+        const std::string& baseName = baseNames[i];
+        std::string sharedLib = baseName + ".so";
 
         // ---- LOAD SHARED LIBRARY ----
-	std::string soPath = "./" + sharedLib;
+	// dlopen needs a slash to look in the directory instead of the library path
+	std::string soPath = std::filesystem::absolute(libPaths[i]).string();
 	void* handle = dlopen(soPath.c_str(), RTLD_LAZY);
         if (!handle)
         {
@@ -232,34 +417,51 @@ std::map<std::string, RobotBase*> loadRobotsFromDirectory(const std::string& dir
             continue;
         }
 
-        // ---- CREATE THE ROBOT ----
-        RobotBase* robot = create_robot();
-        if (!robot)
-        {
-            std::cerr << "ERROR: create_robot() returned null for "
-                      << sharedLib << "\n";
-            dlclose(handle);
-            continue;
-        }
+        // the library stays open for the life of the program
+        factories.push_back({baseName, create_robot});
+    }
+
+    return factories;
+}
+std::map<std::string, RobotBase*> createRobots(const std::vector<LoadedRobot>& factories, bool verbose, int instances)
+{
+    std::map<std::string, RobotBase*> robots;
+    int robotNumber = 0;
 
-        // ---- ASSIGN UNIQUE MAP KEY ("R@", "R#", ...) ----
-        if (symbolIndex >= (int)symbols.size())
+    for (int copy = 0; copy < instances; copy++)
+    {
+        for (const LoadedRobot& factory : factories)
         {
-            std::cerr << "ERROR: Too many robots for available symbols!\n";
-            break;
-        }
+            // ---- CREATE THE ROBOT ----
+            RobotBase* robot = factory.create();
+            if (!robot)
+            {
+                std::cerr << "ERROR: create_robot() returned null for "
+                          << factory.name << "\n";
+                continue;
+            }
+
+            // ---- ASSIGN UNIQUE MAP KEY ("R@", "R#", ..., "R@1", ...) ----
+            std::string robotKey = robotToken(robotNumber++);
 
-        std::string robotKey = "R";
-        robotKey += symbols[symbolIndex++];
-	
-	robot->m_name = baseName;          // gives it a real name
-	robot->m_character = robotKey[1];
+            robot->m_name = factory.name;          // gives it a real name
+            robot->m_character = robotKey[1];
 
-        robots[robotKey] = robot;
+            robots[robotKey] = robot;
 
-        std::cout << "Loaded robot: " << robotKey << "\n";
+            if (verbose)
+                std::cout << "Loaded robot: " << robotKey << "\n";
+        }
     }
 
+    return robots;
+}
+std::map<std::string, RobotBase*> loadRobotsFromDirectory(const std::string& directory, bool forceRebuild,
+                                                          int instances)
+{
+    std::map<std::string, RobotBase*> robots =
+        createRobots(loadRobotFactories(directory, forceRebuild), true, instances);
+
     // ---- SAFETY CHECK: NEED AT LEAST TWO ROBOTS ----
     if (robots.size() < 2)
     {
@@ -269,16 +471,523 @@ std::map<std::string, RobotBase*> loadRobotsFromDirectory(const std::string& dir
 
     return robots;
 }
-void runInteractiveGame()
+int playGame(Arena& arena, int maxRounds)
+{
+    int round = 1;
+
+    while (round <= maxRounds && arena.getAlive() > 1)
+    {
+        arena.iterate();
+        round++;
+    }
+
+    return round - 1;
+}
+GameSetup defaultGameSetup()
+{
+    GameSetup setup;
+    setup.height = 20;
+    setup.width = 20;
+    setup.numObstacles = 30;
+    setup.numPits = 0;
+    setup.numMounds = 0;
+    setup.numFlames = 0;
+    setup.maxRounds = 200;
+    setup.watchLive = false;
+    setup.tickRate = 10;
+    setup.seed = randomSeed();
+    setup.robotDirectory = ".";
+    setup.instances = 1;
+    setup.simultaneousRadar = false;
+    setup.deadlineMicros = 0;
+    setup.profile = 0;
+    return setup;
+}
+bool parseInt(const std::string& value, int& out)
+{
+    size_t used = 0;
+    int parsed;
+    try
+    {
+        parsed = std::stoi(value, &used);
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    if (used != value.size())
+        return false;
+    out = parsed;   // untouched on failure
+    return true;
+}
+bool applyGameOption(GameSetup& setup, const std::string& key, const std::string& value, std::string& error)
+{
+    int* intField = nullptr;
+    if (key == "height")                 intField = &setup.height;
+    else if (key == "width")             intField = &setup.width;
+    else if (key == "obstacles")         intField = &setup.numObstacles;
+    else if (key == "pits")              intField = &setup.numPits;
+    else if (key == "mounds")            intField = &setup.numMounds;
+    else if (key == "flamethrowers")     intField = &setup.numFlames;
+    else if (key == "max_rounds")        intField = &setup.maxRounds;
+    else if (key == "tick_rate")         intField = &setup.tickRate;
+    else if (key == "instances")         intField = &setup.instances;
+    else if (key == "deadline_us")       intField = &setup.deadlineMicros;
+
+    if (intField)
+    {
+        if (!parseInt(value, *intField))
+        {
+            error = "'" + key + "' must be an integer, got '" + value + "'";
+            return false;
+        }
+        return true;
+    }
+
+    bool* boolField = nullptr;
+    if (key == "watch_live")                 boolField = &setup.watchLive;
+    else if (key == "simultaneous_radar")    boolField = &setup.simultaneousRadar;
+
+    if (boolField)
+    {
+        if (value == "y" || value == "yes" || value == "true" || value == "1")
+            *boolField = true;
+        else if (value == "n" || value == "no" || value == "false" || value == "0")
+            *boolField = false;
+        else
+        {
+            error = "'" + key + "' must be y or n, got '" + value + "'";
+            return false;
+        }
+        return true;
+    }
+
+    if (key == "seed")
+    {
+        size_t used = 0;
+        std::uint64_t seed = 0;
+        try
+        {
+            // stoull would wrap "-1" round to a huge seed
+            if (value.find('-') == std::string::npos)
+                seed = std::stoull(value, &used);
+        }
+        catch (const std::exception&)
+        {
+            used = 0;
+        }
+        if (used == 0 || used != value.size())
+        {
+            error = "'seed' must be a non-negative integer, got '" + value + "'";
+            return false;
+        }
+        setup.seed = seed;
+        return true;
+    }
+
+    if (key == "profile")
+    {
+        if (value == "n" || value == "no" || value == "false" || value == "0")
+            setup.profile = 0;
+        else if (value == "y" || value == "yes" || value == "true" || value == "1")
+            setup.profile = 1;
+        else if (value == "cycles")
+            setup.profile = 2;
+        else
+        {
+            error = "'profile' must be y, n or cycles, got '" + value + "'";
+            return false;
+        }
+        return true;
+    }
+
+    if (key == "robot_dir")
+    {
+        setup.robotDirectory = value;
+        return true;
+    }
+
+    if (key == "record")
+    {
+        setup.recordPath = value;
+        return true;
+    }
+
+    error = "unknown setting '" + key + "'";
+    return false;
+}
+bool loadGameConfig(const std::string& path, GameSetup& setup, std::string& error)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        error = "cannot open config file " + path;
+        return false;
+    }
+
+    auto trim = [](const std::string& text)
+    {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+            return std::string();
+        size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    };
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        lineNumber++;
+
+        // ---- STRIP COMMENTS AND BLANK LINES ----
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos)
+        {
+            error = path + ":" + std::to_string(lineNumber) + ": expected key = value";
+            return false;
+        }
+
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        if (!applyGameOption(setup, key, value, error))
+        {
+            error = path + ":" + std::to_string(lineNumber) + ": " + error;
+            return false;
+        }
+    }
+
+    return true;
+}
+bool validateGameSetup(const GameSetup& setup, std::string& error)
+{
+    // same limits promptGameSetup enforces
+    if (setup.height < 10 || setup.width < 10)
+    {
+        error = "arena must be at least 10 x 10";
+        return false;
+    }
+    if (setup.numObstacles < 0 || setup.numPits < 0 ||
+        setup.numMounds < 0 || setup.numFlames < 0)
+    {
+        error = "obstacle counts cannot be negative";
+        return false;
+    }
+    // obstacles only go inside the border; robots are checked by the arena
+    long long maxCells = static_cast<long long>(setup.height - 2) * (setup.width - 2);
+    long long obstacles = static_cast<long long>(setup.numObstacles) +
+                          setup.numPits + setup.numMounds + setup.numFlames;
+    if (obstacles > maxCells)
+    {
+        error = "too many obstacles, at most " + std::to_string(maxCells) + " fit inside the border";
+        return false;
+    }
+    if (setup.maxRounds <= 0)
+    {
+        error = "max_rounds must be a positive integer";
+        return false;
+    }
+    if (setup.tickRate < 0)
+    {
+        error = "tick_rate cannot be negative (0 = unlimited)";
+        return false;
+    }
+    if (setup.instances <= 0)
+    {
+        error = "instances must be a positive integer";
+        return false;
+    }
+    if (setup.deadlineMicros < 0)
+    {
+        error = "deadline_us cannot be negative (0 = no limit)";
+        return false;
+    }
+    return true;
+}
+bool parseCommandLine(int argc, char* argv[], CommandLine& command, std::string& error)
+{
+    TournamentSetup& tournament = command.tournament;
+    tournament.game = defaultGameSetup();
+    tournament.numGames = 0;
+    tournament.numThreads = 0;
+    tournament.forceRebuild = false;
+
+    // ---- CONFIG FILE FIRST SO COMMAND-LINE SETTINGS OVERRIDE IT ----
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]) == "--config")
+        {
+            if (!loadGameConfig(argv[i + 1], tournament.game, error))
+                return false;
+            command.configured = true;
+        }
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--config" && i + 1 < argc)
+        {
+            i++;   // already loaded
+        }
+        else if (arg == "--tournament" && i + 1 < argc)
+        {
+            if (!parseInt(argv[++i], tournament.numGames) || tournament.numGames <= 0)
+            {
+                error = "--tournament needs a positive game count";
+                return false;
+            }
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            if (!parseInt(argv[++i], tournament.numThreads) || tournament.numThreads < 0)
+            {
+                error = "--threads needs a thread count, 0 for one per core";
+                return false;
+            }
+        }
+        else if (arg == "--replay" && i + 1 < argc)
+        {
+            command.replayPath = argv[++i];
+        }
+        else if (arg == "--round" && i + 1 < argc)
+        {
+            if (!parseInt(argv[++i], command.replayRound) || command.replayRound <= 0)
+            {
+                error = "--round needs a positive round number";
+                return false;
+            }
+        }
+        else if (arg == "--rebuild")
+        {
+            tournament.forceRebuild = true;
+        }
+        else if (arg.rfind("--", 0) == 0 && i + 1 < argc)
+        {
+            // --max-rounds and --max_rounds both name "max_rounds"
+            std::string key = arg.substr(2);
+            for (char& c : key)
+            {
+                if (c == '-')
+                    c = '_';
+            }
+
+            if (!applyGameOption(tournament.game, key, argv[++i], error))
+            {
+                command.showUsage = true;
+                return false;
+            }
+            command.configured = true;
+        }
+        else
+        {
+            command.showUsage = true;
+            return false;
+        }
+    }
+    return true;
+}
+std::uint64_t randomSeed()
 {
-    GameSetup setup = promptGameSetup();
+    std::random_device device;
+    return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+}
+void runTournament(const TournamentSetup& tournament)
+{
+    std::vector<LoadedRobot> factories = loadRobotFactories(tournament.game.robotDirectory, tournament.forceRebuild);
+    if (factories.size() * tournament.game.instances < 2)
+    {
+        std::cerr << "ERROR: Need at least two robots to play!\n";
+        std::exit(1);
+    }
 
-    auto robots = loadRobotsFromDirectory(".");
+    ThreadPool pool(tournament.numThreads);
+    std::cout << "Running " << tournament.numGames << " games on "
+              << pool.size() << " threads, seed " << tournament.game.seed << "\n";
 
+    // one slot per game so workers never share results
+    struct GameResult
+    {
+        std::string winner;
+        std::map<std::string, int> finalHealth;
+        std::map<std::string, std::string> names;
+        std::map<std::string, int> overruns;
+        int rounds = 0;
+        std::string error;   // the board could not be set up
+    };
+    std::vector<GameResult> results(tournament.numGames);
+
+    pool.parallelFor(tournament.numGames, [&](int game)
+    {
+        std::map<std::string, RobotBase*> robots = createRobots(factories, false, tournament.game.instances);
+        GameSetup setup = tournament.game;
+        setup.seed += game;
+        GameResult& result = results[game];
+        std::set<std::string> busy;   // robots stuck in a call when the game ended
+        try
+        {
+            Arena arena = buildArena(setup, robots);
+            // games already fill the pool, so each one scans on its own thread
+            arena.setSimultaneousRadar(setup.simultaneousRadar);
+            arena.setCallbackDeadline(setup.deadlineMicros);
+            // game i goes to "<record>.<i>"
+            if (!setup.recordPath.empty() &&
+                !arena.startReplay(setup.recordPath + "." + std::to_string(game)))
+            {
+                std::cerr << "ERROR: cannot write replay "
+                          << setup.recordPath << "." << game << "\n";
+            }
+
+            result.rounds = playGame(arena, tournament.game.maxRounds);
+            // robots stuck in a call lose, here and in getWinner() alike
+            for (int index : arena.retireBusyRobots())
+                busy.insert(arena.getRobotId(index));
+            result.winner = arena.getWinner();
+            for (int index = 0; index < arena.getRobotCount(); index++)
+                result.overruns[arena.getRobotId(index)] = arena.getOverruns(index);
+            if (!arena.finishReplay())
+            {
+                std::cerr << "ERROR: replay " << setup.recordPath << "." << game
+                          << " is incomplete, writing it failed\n";
+            }
+        }   // the arena, and any idle robot threads, end before the robots do
+        catch (const std::runtime_error& failure)
+        {
+            result.error = failure.what();
+        }
+
+        for (const auto& [key, robot] : robots)
+        {
+            result.names[key] = robot->m_name;
+            if (busy.count(key))
+            {
+                // its thread may still be inside it: counts as dead, and
+                // is left alive rather than deleted under that thread
+                result.finalHealth[key] = 0;
+                continue;
+            }
+            result.finalHealth[key] = robot->get_health();
+            delete robot;
+        }
+    });
+
+    // every game has the same board and robots, so one failing means all do
+    if (!results.empty() && !results[0].error.empty())
+    {
+        std::cerr << "ERROR: " << results[0].error << "\n";
+        std::exit(1);
+    }
+
+    // ---- TALLY PER-ROBOT STATISTICS ----
+    struct RobotStats
+    {
+        std::string name;
+        int wins = 0;
+        int draws = 0;
+        int losses = 0;
+        int survived = 0;
+        long long totalHealth = 0;
+        long long overruns = 0;
+    };
+    std::map<std::string, RobotStats> stats;
+    long long totalRounds = 0;
+
+    for (const GameResult& result : results)
+    {
+        totalRounds += result.rounds;
+        for (const auto& [key, health] : result.finalHealth)
+        {
+            RobotStats& robot = stats[key];
+            robot.name = result.names.at(key);
+
+            // no winner: the survivors draw, the dead still lost
+            if (result.winner == key)
+                robot.wins++;
+            else if (result.winner == "none" && health > 0)
+                robot.draws++;
+            else
+                robot.losses++;
+
+            if (health > 0)
+                robot.survived++;
+            robot.totalHealth += health;
+            robot.overruns += result.overruns.at(key);
+        }
+    }
+
+    int games = tournament.numGames;
+    std::cout << "=========== tournament results ===========\n\n";
+    std::cout << "games: " << games << "  average rounds: "
+              << (games > 0 ? static_cast<double>(totalRounds) / games : 0.0) << "\n\n";
+
+    for (const auto& [key, robot] : stats)
+    {
+        std::cout << key << " " << robot.name
+                  << "  wins: " << robot.wins
+                  << "  draws: " << robot.draws
+                  << "  losses: " << robot.losses
+                  << "  win%: " << 100.0 * robot.wins / games
+                  << "  survival%: " << 100.0 * robot.survived / games
+                  << "  avg health: " << static_cast<double>(robot.totalHealth) / games;
+        if (tournament.game.deadlineMicros > 0)
+            std::cout << "  overruns: " << robot.overruns;
+        std::cout << "\n";
+    }
+}
+// Builds the arena for a single game and plays it; throws
+// std::runtime_error if the board cannot fit everything.
+static void playSingleGame(const GameSetup& setup, std::map<std::string, RobotBase*>& robots)
+{
     Arena arena = buildArena(setup, robots);
 
+    std::unique_ptr<ThreadPool> radarPool;
+    if (setup.simultaneousRadar)
+    {
+        radarPool = std::make_unique<ThreadPool>();
+        arena.setSimultaneousRadar(true, radarPool.get());
+    }
+    arena.setCallbackDeadline(setup.deadlineMicros);
+    if (setup.profile > 0)
+        arena.enableProfiling(setup.profile == 2 ? LatencyProfiler::Cycles : LatencyProfiler::Nanoseconds);
+    if (!setup.recordPath.empty() && !arena.startReplay(setup.recordPath))
+    {
+        std::cerr << "ERROR: cannot write replay " << setup.recordPath << "\n";
+        std::exit(1);
+    }
+
     runGame(arena, robots,
             setup.maxRounds,
-            setup.watchLive);
+            setup.watchLive,
+            setup.tickRate);
+
+    if (!arena.finishReplay())
+    {
+        std::cerr << "ERROR: replay " << setup.recordPath << " is incomplete, writing it failed\n";
+        std::exit(1);
+    }
 }
+void runSingleGame(const GameSetup& setup, bool forceRebuild)
+{
+    auto robots = loadRobotsFromDirectory(setup.robotDirectory, forceRebuild, setup.instances);
+
+    std::cout << "Seed: " << setup.seed << "\n";
 
+    try
+    {
+        playSingleGame(setup, robots);
+    }
+    catch (const std::runtime_error& failure)
+    {
+        std::cerr << "ERROR: " << failure.what() << "\n";
+        std::exit(1);
+    }
+}
+void runInteractiveGame(bool forceRebuild)
+{
+    runSingleGame(promptGameSetup(), forceRebuild);
+}
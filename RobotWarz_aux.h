@@ -4,17 +4,76 @@
 #include "RobotBase.h"
 #include <map>
 #include <string>
+#include <vector>
+#include <cstdint>
 struct GameSetup
 {
     int height;
     int width;
-    int numObstacles;
+    int numObstacles;     // random type
+    int numPits;          // exact counts per type
+    int numMounds;
+    int numFlames;
     int maxRounds;
     bool watchLive;
+    int tickRate;         // live rounds per second, 0 = unlimited
+    std::uint64_t seed;   // same seed + same robots = same game
+    std::string robotDirectory;
+    int instances;        // robots spawned from each loaded library
+    bool simultaneousRadar;  // scan every robot at the start of each round
+    int deadlineMicros;   // per robot callback, 0 = no limit
+    int profile;          // 0 = off, 1 = latency in ns, 2 = in cycles
+    std::string recordPath;  // replay log to write, "" = none
+};
+// A compiled robot library: its base name ("Robot_Ratboy") and factory.
+struct LoadedRobot
+{
+    std::string name;
+    RobotFactory create;
+};
+// Headless batch of independent games run on a thread pool.
+struct TournamentSetup
+{
+    GameSetup game;
+    int numGames;     // game i is seeded with game.seed + i
+    int numThreads;   // 0 = one per core
+    bool forceRebuild;
+};
+// What the command line asked for.
+struct CommandLine
+{
+    TournamentSetup tournament;
+    bool configured = false;   // a config file or a setting was given
+    std::string replayPath;    // "" = play a game
+    int replayRound = 0;       // 0 = the whole replay
+    bool showUsage = false;    // after a failed parse, print the usage too
 };
 GameSetup promptGameSetup();
-std::map<std::string, RobotBase*> loadRobotsFromDirectory(const std::string& directory);
+GameSetup defaultGameSetup();
+std::uint64_t randomSeed();
+// The whole of value as an int ("12", "-3"); false, leaving out alone, for
+// "", "12x" or out of range.
+bool parseInt(const std::string& value, int& out);
+// Sets one GameSetup field by its config name ("height", "max_rounds", ...).
+// Returns false and fills error if the key or value is bad.
+bool applyGameOption(GameSetup& setup, const std::string& key, const std::string& value, std::string& error);
+// Reads "key = value" lines ('#' starts a comment) on top of setup.
+bool loadGameConfig(const std::string& path, GameSetup& setup, std::string& error);
+bool validateGameSetup(const GameSetup& setup, std::string& error);
+// Reads --config files before anything else, so settings on the command
+// line override them wherever they appear. False with error filled (it
+// may be empty when only the usage applies) on a bad argument.
+bool parseCommandLine(int argc, char* argv[], CommandLine& command, std::string& error);
+// Robot libraries are rebuilt only when their source, the compile flags or
+// RobotBase_pic.o change (see Robot_*.so.key), unless forceRebuild is set.
+std::vector<LoadedRobot> loadRobotFactories(const std::string& directory, bool forceRebuild = false);
+std::map<std::string, RobotBase*> createRobots(const std::vector<LoadedRobot>& factories, bool verbose, int instances = 1);
+std::map<std::string, RobotBase*> loadRobotsFromDirectory(const std::string& directory, bool forceRebuild = false,
+                                                          int instances = 1);
 Arena buildArena(const GameSetup& setup, std::map<std::string, RobotBase*>& robots);
-void runGame(Arena& arena, const std::map<std::string, RobotBase*>& robots, int maxRounds, bool watchLive);
-void runInteractiveGame();
+void runGame(Arena& arena, const std::map<std::string, RobotBase*>& robots, int maxRounds, bool watchLive, int tickRate = 10);
+int playGame(Arena& arena, int maxRounds);
+void runSingleGame(const GameSetup& setup, bool forceRebuild = false);
+void runInteractiveGame(bool forceRebuild = false);
+void runTournament(const TournamentSetup& tournament);
 #endif
@@ -0,0 +1,76 @@
+#ifndef _SCRIPTEDROBOT_H_
+#define _SCRIPTEDROBOT_H_
+#include "RobotBase.h"
+#include "RadarObj.h"
+#include <cstdint>
+#include <vector>
+// A small LCG: the same seed gives the same numbers on every run and
+// platform, which is all the benchmarks and the fuzzer need.
+class Script {
+	public:
+		explicit Script(std::uint32_t state): mState(state){
+		}
+		// 0 ... bound - 1
+		int next(int bound){
+			mState = mState * 1103515245u + 12345u;
+			return static_cast<int>((mState >> 8) % static_cast<std::uint32_t>(bound));
+		}
+	private:
+		std::uint32_t mState;
+};
+// An in-process robot whose every decision comes from its Script, so the
+// same seed and the same radar results give the same game. It shoots at
+// robots it saw (most of the time), now and then at a random cell, and
+// wanders. A wild robot also asks for what the arena must refuse: radar
+// direction 9, direction 0, shots off the board, moves past its speed.
+class ScriptedRobot : public RobotBase {
+	public:
+		ScriptedRobot(int move, int armor, WeaponType weapon, std::uint32_t seed,
+		              int height, int width, bool wild):
+			RobotBase(move, armor, weapon),
+			mScript(seed), mHeight(height), mWidth(width), mWild(wild){
+		}
+		void get_radar_direction(int& radar_direction) override {
+			radar_direction = mScript.next(mWild ? 10 : 9);
+		}
+		void process_radar_results(const std::vector<RadarObj>& radar_results) override {
+			seen = radar_results;
+		}
+		bool get_shot_location(int& shot_row, int& shot_col) override {
+			for(const RadarObj& object : seen){
+				if(object.m_type == 'R' && mScript.next(3) != 0){
+					shot_row = object.m_row;
+					shot_col = object.m_col;
+					return true;
+				};
+			};
+			if(mScript.next(4) != 0){
+				return false;
+			};
+			if(mWild){
+				shot_row = mScript.next(mHeight + 2) - 1;
+				shot_col = mScript.next(mWidth + 2) - 1;
+			}else{
+				shot_row = mScript.next(mHeight);
+				shot_col = mScript.next(mWidth);
+			};
+			return true;
+		}
+		void get_move_direction(int& direction, int& distance) override {
+			if(mWild){
+				direction = mScript.next(9);
+				distance = mScript.next(get_move_speed() + 2);
+			}else{
+				direction = 1 + mScript.next(8);
+				distance = mScript.next(get_move_speed() + 1);
+			};
+		}
+		// the last radar results handed to the robot
+		std::vector<RadarObj> seen;
+	private:
+		Script mScript;
+		int mHeight;
+		int mWidth;
+		bool mWild;
+};
+#endif
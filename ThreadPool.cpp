@@ -0,0 +1,78 @@
+#include "ThreadPool.h"
+ThreadPool::ThreadPool(int numThreads):
+	mTask(nullptr),
+	mCount(0),
+	mNext(0),
+	mFinished(0),
+	mGeneration(0),
+	mStopping(false){
+	if(numThreads <= 0){
+		numThreads = static_cast<int>(std::thread::hardware_concurrency());
+	};
+	if(numThreads <= 0){
+		numThreads = 1;
+	};
+	// the caller of parallelFor is the last worker
+	for(int i = 1; i < numThreads; i++){
+		mWorkers.emplace_back(&ThreadPool::workerLoop, this);
+	};
+};
+ThreadPool::~ThreadPool(){
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mWake.notify_all();
+	for(auto& worker : mWorkers){
+		worker.join();
+	};
+};
+int ThreadPool::size() const{
+	return static_cast<int>(mWorkers.size()) + 1;
+};
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& task){
+	if(count <= 0){
+		return;
+	};
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTask = &task;
+		mCount = count;
+		mNext = 0;
+		mFinished = 0;
+		mGeneration++;
+	}
+	mWake.notify_all();
+	runTasks();
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mDone.wait(lock, [this]{ return mFinished == mCount; });
+	mTask = nullptr;
+};
+void ThreadPool::runTasks(){
+	std::unique_lock<std::mutex> lock(mMutex);
+	while(mTask && mNext < mCount){
+		int index = mNext++;
+		const std::function<void(int)>& task = *mTask;
+		lock.unlock();
+		task(index);
+		lock.lock();
+		if(++mFinished == mCount){
+			mDone.notify_all();
+		};
+	};
+};
+void ThreadPool::workerLoop(){
+	unsigned long seen = 0;
+	while(true){
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWake.wait(lock, [&]{ return mStopping || mGeneration != seen; });
+			if(mStopping){
+				return;
+			};
+			seen = mGeneration;
+		}
+		runTasks();
+	};
+};
@@ -0,0 +1,33 @@
+#ifndef _THREADPOOL_H_
+#define _THREADPOOL_H_
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+// A fixed set of worker threads that runs parallelFor jobs. The calling
+// thread helps out, so a pool of size 1 runs everything inline.
+class ThreadPool {
+	public:
+		explicit ThreadPool(int numThreads = 0);
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		// Calls task(i) for every i in [0, count) and returns when all are done.
+		void parallelFor(int count, const std::function<void(int)>& task);
+		int size() const;
+	private:
+		void workerLoop();
+		void runTasks();
+		std::vector<std::thread> mWorkers;
+		std::mutex mMutex;
+		std::condition_variable mWake;
+		std::condition_variable mDone;
+		const std::function<void(int)>* mTask;
+		int mCount;
+		int mNext;
+		int mFinished;
+		unsigned long mGeneration;
+		bool mStopping;
+};
+#endif
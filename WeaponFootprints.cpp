@@ -0,0 +1,58 @@
+#include "WeaponFootprints.h"
+#include "LineTrace.h"
+#include <cstdlib>
+#include <utility>
+#include <vector>
+// slope buckets: floor(24 * minor / major) is 0..24
+static const int kSlopes = 25;
+
+static int footprintKey(int signR, int signC, bool rowMajor, int slope){
+	return (((signR + 1) * 3 + (signC + 1)) * 2 + (rowMajor ? 1 : 0)) * kSlopes + slope;
+};
+static std::vector<Offset> buildFlameTable(){
+	std::vector<Offset> table(static_cast<size_t>(9 * 2 * kSlopes) * kFlameCells, Offset{0, 0});
+	for(int signR = -1; signR <= 1; signR++){
+		for(int signC = -1; signC <= 1; signC++){
+			for(int rowMajor = 0; rowMajor <= 1; rowMajor++){
+				for(int slope = 0; slope < kSlopes; slope++){
+					// a representative shot with major axis 24 in this bucket
+					int dr = signR * (rowMajor ? 24 : slope);
+					int dc = signC * (rowMajor ? slope : 24);
+					LineTrace trace(dr, dc);
+					if(trace.empty()){
+						continue;
+					};
+
+					Offset* cells = &table[static_cast<size_t>(footprintKey(signR, signC, rowMajor, slope)) * kFlameCells];
+					int i = 0;
+					for(int step = 1; step <= 4; step++){
+						for(int w = -1; w <= 1; w++){
+							cells[i].dr = static_cast<signed char>(trace.rowOffset(step) + trace.perpRow() * w);
+							cells[i].dc = static_cast<signed char>(trace.colOffset(step) + trace.perpCol() * w);
+							i++;
+						};
+					};
+				};
+			};
+		};
+	};
+	return table;
+};
+const Offset* flameFootprint(int dr, int dc){
+	static const std::vector<Offset> table = buildFlameTable();
+
+	int major = std::abs(dr);
+	int minor = std::abs(dc);
+	bool rowMajor = major >= minor;
+	if(!rowMajor){
+		std::swap(major, minor);
+	};
+	if(major == 0){
+		return nullptr;
+	};
+
+	int slope = static_cast<int>(24LL * minor / major);
+	int signR = (dr > 0) - (dr < 0);
+	int signC = (dc > 0) - (dc < 0);
+	return &table[static_cast<size_t>(footprintKey(signR, signC, rowMajor, slope)) * kFlameCells];
+};
@@ -0,0 +1,30 @@
+#ifndef _WEAPONFOOTPRINTS_H_
+#define _WEAPONFOOTPRINTS_H_
+// Cells a weapon hits, as offsets from a centre cell, so handle_shot only
+// has to clip them to the board and apply damage.
+struct Offset {
+	signed char dr;
+	signed char dc;
+};
+
+// grenade: the target and its 8 neighbours, in grenadeRadius order
+constexpr Offset kGrenadeFootprint[] = {
+	{-1, -1}, {-1, 0}, {-1, 1},
+	{ 0, -1}, { 0, 0}, { 0, 1},
+	{ 1, -1}, { 1, 0}, { 1, 1}
+};
+
+// hammer: just the (adjacent) target cell
+constexpr Offset kHammerFootprint[] = { {0, 0} };
+
+constexpr int kFlameCells = 12;
+
+// The 12 cells of a flamethrower shot along (dr, dc), relative to the
+// shooter and in flamePath order, or nullptr for a zero vector.
+//
+// A flame only reaches 4 steps, and step k sits round(k * minor / major)
+// across, which only changes where 24 * minor / major crosses an integer.
+// So every direction shares its footprint with one of 25 slopes per
+// octant; the table of all of them is built once on first use.
+const Offset* flameFootprint(int dr, int dc);
+#endif
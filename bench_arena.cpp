@@ -0,0 +1,264 @@
+#include "Arena.h"
+#include "ArenaSnapshot.h"
+#include "RobotBase.h"
+#include "RobotToken.h"
+#include "ScriptedRobot.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Timings of the Arena hot paths (and of snapshot, restore and fork)
+// over board sizes, obstacle densities and robot counts. Robots are
+// scripted in-process and every arena is built from a fixed seed, so two
+// runs do the same work and their numbers can be compared directly.
+//
+// Output is CSV on stdout, one row per benchmark and setup:
+//   bench,height,width,obstacles,robots,calls,ns_per_call
+// ns_per_call is the best of a few repetitions. Progress goes to stderr.
+//
+// usage: bench_arena [--quick]   (--quick stops at 500x500)
+
+static const std::uint64_t kSeed = 20240601;
+static const int kQueryCalls = 10000;   // path and radar lookups per repetition
+static const int kActionCalls = 2000;   // moves and shots per repetition
+static const long long kCopyCells = 20000000;   // cells copied per snapshot/fork repetition
+static const int kRounds = 20;          // iterate() calls per repetition
+static const int kRepetitions = 3;
+
+// keeps results alive so the timed calls are not optimised away
+static volatile std::size_t sink = 0;
+
+struct Setup
+{
+    int size;          // square board
+    int density;       // percent of the interior covered by obstacles
+    int robots;
+    int obstacles() const { return (size - 2) * (size - 2) * density / 100; }
+};
+
+// One arena and its robots, rebuilt from the seed whenever a benchmark
+// changes the board.
+struct World
+{
+    std::vector<RobotBase*> robots;
+    Arena* arena = nullptr;
+
+    explicit World(const Setup& setup)
+    {
+        std::map<std::string, RobotBase*> byToken;
+        for (int i = 0; i < setup.robots; i++)
+        {
+            std::string token = robotToken(i);
+            // robots keep to the board, varied by their number
+            RobotBase* robot = new ScriptedRobot(2 + i % 4, 2, static_cast<WeaponType>(i % 4),
+                                                 i * 2654435761u + 1, setup.size, setup.size, false);
+            robot->m_name = "Bench" + std::to_string(i);
+            robot->m_character = token[1];
+            byToken[token] = robot;
+        }
+        // the arena orders robots by token, so index them the same way
+        for (const auto& [token, robot] : byToken)
+            robots.push_back(robot);
+        arena = new Arena(setup.size, setup.size, byToken, setup.obstacles(), kSeed);
+    }
+    ~World()
+    {
+        delete arena;
+        for (RobotBase* robot : robots)
+            delete robot;
+    }
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    // a living robot, picked by the script; -1 once all are dead
+    int pickLiving(Script& script) const
+    {
+        int start = script.next(static_cast<int>(robots.size()));
+        for (size_t i = 0; i < robots.size(); i++)
+        {
+            int index = static_cast<int>((start + i) % robots.size());
+            if (robots[index]->get_health() > 0)
+                return index;
+        }
+        return -1;
+    }
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static double nanosSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+static void report(const char* bench, const Setup& setup, int calls, double bestNanos)
+{
+    std::cout << bench << "," << setup.size << "," << setup.size << "," << setup.obstacles() << ","
+              << setup.robots << "," << calls << "," << static_cast<long long>(bestNanos / calls) << "\n";
+}
+
+// ---- READ-ONLY QUERIES: ONE ARENA, SEVERAL PASSES ----
+template <typename Call>
+static void benchQuery(const char* bench, const Setup& setup, Call call, int calls = kQueryCalls)
+{
+    double best = 0;
+    for (int rep = 0; rep < kRepetitions; rep++)
+    {
+        Script script(7);
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < calls; i++)
+            call(script, i);
+        double elapsed = nanosSince(start);
+        if (rep == 0 || elapsed < best)
+            best = elapsed;
+    }
+    report(bench, setup, calls, best);
+}
+
+// ---- ACTIONS CHANGE THE BOARD: A FRESH ARENA EACH PASS, BUILT UNTIMED ----
+template <typename Call>
+static void benchAction(const char* bench, const Setup& setup, int calls, Call call)
+{
+    double best = 0;
+    for (int rep = 0; rep < kRepetitions; rep++)
+    {
+        World world(setup);
+        Script script(11);
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < calls; i++)
+            call(world, script);
+        double elapsed = nanosSince(start);
+        if (rep == 0 || elapsed < best)
+            best = elapsed;
+    }
+    report(bench, setup, calls, best);
+}
+
+static void runSetup(const Setup& setup)
+{
+    std::cerr << setup.size << "x" << setup.size << ", " << setup.density << "% obstacles, "
+              << setup.robots << " robots\n";
+
+    World world(setup);
+    Arena& arena = *world.arena;
+    int size = setup.size;
+    int count = setup.robots;
+
+    auto origin = [&](int i, int& row, int& col)
+    {
+        world.robots[i % count]->get_current_location(row, col);
+    };
+
+    benchQuery("radarPath", setup, [&](Script&, int i)
+    {
+        int row, col;
+        origin(i, row, col);
+        sink = sink + arena.radarPath(row, col, 1 + i % 8).size();
+    });
+
+    std::vector<RadarObj> results;
+    benchQuery("get_radar_results", setup, [&](Script&, int i)
+    {
+        results.clear();
+        arena.get_radar_results(world.robots[i % count], i % 9, results);
+        sink = sink + results.size();
+    });
+
+    benchQuery("railgunPath", setup, [&](Script& script, int i)
+    {
+        int row, col;
+        origin(i, row, col);
+        sink = sink + arena.railgunPath(row, col, script.next(size), script.next(size)).size();
+    });
+
+    benchQuery("flamePath", setup, [&](Script& script, int i)
+    {
+        int row, col;
+        origin(i, row, col);
+        sink = sink + arena.flamePath(row, col, script.next(size), script.next(size)).size();
+    });
+
+    benchQuery("grenadeRadius", setup, [&](Script& script, int)
+    {
+        sink = sink + arena.grenadeRadius(script.next(size), script.next(size)).size();
+    });
+
+    // what-if search: save once, then play and put back over and over;
+    // these copy the whole board, so big boards get fewer calls
+    int copies = static_cast<int>(std::min<long long>(kQueryCalls,
+                                                      std::max<long long>(10, kCopyCells / (size * size))));
+    ArenaSnapshot saved;
+    benchQuery("snapshot", setup, [&](Script&, int)
+    {
+        arena.snapshot(saved);
+        sink = sink + saved.cells.size();
+    }, copies);
+
+    benchQuery("restore", setup, [&](Script&, int)
+    {
+        arena.restore(saved);
+        sink = sink + arena.getAlive();
+    }, copies);
+
+    benchQuery("fork", setup, [&](Script&, int)
+    {
+        sink = sink + arena.fork()->getRobotCount();
+    }, copies);
+
+    benchAction("handle_movement", setup, kActionCalls, [&](World& fresh, Script& script)
+    {
+        int index = fresh.pickLiving(script);
+        if (index < 0)
+            return;
+        RobotBase* robot = fresh.robots[index];
+        fresh.arena->handle_movement(index, robot, 1 + script.next(8),
+                                     script.next(robot->get_move_speed() + 1));
+    });
+
+    benchAction("handle_shot", setup, kActionCalls, [&](World& fresh, Script& script)
+    {
+        int index = fresh.pickLiving(script);
+        if (index < 0)
+            return;
+        RobotBase* robot = fresh.robots[index];
+        fresh.arena->handle_shot(robot->get_weapon(), robot, script.next(size), script.next(size));
+    });
+
+    benchAction("iterate", setup, kRounds, [&](World& fresh, Script&)
+    {
+        fresh.arena->iterate();
+    });
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = argc > 1 && std::string(argv[1]) == "--quick";
+
+    const int sizes[] = {10, 100, 500, 2000};
+    const int densities[] = {0, 10, 30};
+    const int robotCounts[] = {2, 12, 48};
+
+    std::cout << "bench,height,width,obstacles,robots,calls,ns_per_call\n";
+    for (int size : sizes)
+    {
+        if (quick && size > 500)
+            break;
+        for (int density : densities)
+        {
+            for (int robots : robotCounts)
+            {
+                Setup setup{size, density, robots};
+                // the smallest board cannot hold that many robots
+                if (robots > size * size - setup.obstacles())
+                    continue;
+                runSetup(setup);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,909 @@
+#include "Arena.h"
+#include "ArenaSnapshot.h"
+#include "ArenaRng.h"
+#include "RobotBase.h"
+#include "RobotToken.h"
+#include "ScriptedRobot.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Differential fuzzer for the Arena. Each case builds the real Arena and a
+// naive reference model of the same rules from one seed, then drives both
+// with the same scripted actions: radar scans, shots, moves, whole rounds
+// of scripted robots, and snapshots, restores and forks of the arena.
+// After every action the grid, each robot's health, armor, speed,
+// grenades and position, the alive count and winner and any radar
+// results must agree. The reference walks every cell the
+// plain way (no occupancy index, footprint tables or incremental counts),
+// so an optimisation that changes a rule shows up as a divergence. That
+// case is then cut down to a small reproducer and printed.
+//
+// usage: fuzz_arena [--cases N] [--seed S]   run N cases from seed S
+//        fuzz_arena --case S                 run (and minimise) one case
+
+// ---- ONE FUZZ CASE ----
+
+enum ActionKind { RadarAction, ShotAction, MoveAction, RoundAction, SnapshotAction, RestoreAction, ForkAction };
+
+struct Action
+{
+    ActionKind kind;
+    int robot;   // arena index, taken modulo the robot count
+    int a;       // radar / move direction, or shot row (also for a fork)
+    int b;       // move distance, or shot column (also for a fork)
+};
+
+struct RobotSpec
+{
+    int move;
+    int armor;
+    WeaponType weapon;
+    std::uint32_t script;
+};
+
+struct Case
+{
+    std::uint64_t seed;   // arena seed
+    int height;
+    int width;
+    int obstacles;
+    int pits;
+    int mounds;
+    int flames;
+    bool simultaneous;
+    std::vector<RobotSpec> robots;   // in arena index order
+    std::vector<Action> actions;
+};
+
+static const char* const kWeaponNames[] = {"flamethrower", "railgun", "grenade", "hammer"};
+
+// Grid tokens for n robots, sorted the way the arena indexes them.
+static std::vector<std::string> sortedTokens(int count)
+{
+    std::vector<std::string> tokens;
+    for (int n = 0; n < count; n++)
+        tokens.push_back(robotToken(n));
+    std::sort(tokens.begin(), tokens.end());
+    return tokens;
+}
+
+// Same decisions from the same inputs, out-of-range ones included.
+static ScriptedRobot* newRobot(const RobotSpec& spec, int height, int width)
+{
+    ScriptedRobot* robot = new ScriptedRobot(spec.move, spec.armor, spec.weapon, spec.script, height, width, true);
+    robot->m_name = "Fuzz";
+    return robot;
+}
+
+// The arena under test, with its RNG readable so the reference starts
+// from the same draw.
+class ArenaUnderTest : public Arena
+{
+public:
+    using Arena::Arena;
+    const ArenaRng& rng() const { return mRng; }
+};
+
+// ---- REFERENCE MODEL: THE RULES, ONE CELL AT A TIME ----
+
+class ReferenceArena
+{
+public:
+    // copies the board, robot positions and RNG of a freshly built arena
+    ReferenceArena(const ArenaUnderTest& start, const std::vector<RobotBase*>& robots, bool simultaneous)
+        : mHeight(start.getHeight()), mWidth(start.getWidth()), mRobots(robots),
+          mRng(start.rng()), mSimultaneous(simultaneous)
+    {
+        for (int row = 0; row < mHeight; row++)
+            for (int col = 0; col < mWidth; col++)
+                mCells.push_back(start.getCell(row, col));
+        for (int index = 0; index < static_cast<int>(mRobots.size()); index++)
+        {
+            for (int cell = 0; cell < mHeight * mWidth; cell++)
+            {
+                if (mCells[cell].type == 'R' && mCells[cell].robot == index)
+                {
+                    mRobots[index]->move_to(cell / mWidth, cell % mWidth);
+                    mRobots[index]->set_boundaries(mHeight, mWidth);
+                }
+            }
+        }
+    }
+
+    const Cell& cell(int row, int col) const { return mCells[row * mWidth + col]; }
+
+    // a copy of the model playing with other robot objects
+    void useRobots(const std::vector<RobotBase*>& robots) { mRobots = robots; }
+
+    void radar(int index, int direction, std::vector<RadarObj>& results) const
+    {
+        results.clear();
+        int sx, sy;
+        mRobots[index]->get_current_location(sx, sy);
+
+        if (direction == 0)
+        {
+            for (int dr = -1; dr <= 1; dr++)
+                for (int dc = -1; dc <= 1; dc++)
+                    if (dr != 0 || dc != 0)
+                        see(sx + dr, sy + dc, results);
+            return;
+        }
+        if (direction < 1 || direction > 8)
+            return;
+
+        // three cells across each step, while the middle one is on the board
+        int stepR = directions[direction].first;
+        int stepC = directions[direction].second;
+        for (int r = sx + stepR, c = sy + stepC; onBoard(r, c); r += stepR, c += stepC)
+            for (int w = -1; w <= 1; w++)
+                see(r - stepC * w, c + stepR * w, results);
+    }
+
+    void shot(int index, WeaponType weapon, int row, int col)
+    {
+        RobotBase* robot = mRobots[index];
+        int sx, sy;
+        robot->get_current_location(sx, sy);
+        int dr = row - sx;
+        int dc = col - sy;
+
+        switch (weapon)
+        {
+            case railgun:
+                if (dr == 0 && dc == 0)
+                    return;
+                for (int step = 1; ; step++)
+                {
+                    int r = sx + lineRow(dr, dc, step);
+                    int c = sy + lineCol(dr, dc, step);
+                    if (!onBoard(r, c))
+                        return;
+                    damage(r, c, 10, 20);
+                }
+
+            case flamethrower:
+            {
+                if (dr == 0 && dc == 0)
+                    return;
+                // across the line: a mostly-vertical shot spreads along
+                // the row, a mostly-horizontal one along the column and
+                // an exact diagonal along both
+                int signR = (dr > 0) - (dr < 0);
+                int signC = (dc > 0) - (dc < 0);
+                bool diagonal = std::abs(dr) == std::abs(dc);
+                bool rowMajor = std::abs(dr) >= std::abs(dc);
+                int acrossR = (diagonal || !rowMajor) ? -signC : 0;
+                int acrossC = (diagonal || rowMajor) ? signR : 0;
+                for (int step = 1; step <= 4; step++)
+                {
+                    for (int w = -1; w <= 1; w++)
+                    {
+                        int r = sx + lineRow(dr, dc, step) + acrossR * w;
+                        int c = sy + lineCol(dr, dc, step) + acrossC * w;
+                        if (onBoard(r, c))
+                            damage(r, c, 30, 50);
+                    }
+                }
+                return;
+            }
+
+            case grenade:
+                if (robot->get_grenades() <= 0)
+                    return;
+                robot->decrement_grenades();
+                for (int r = row - 1; r <= row + 1; r++)
+                    for (int c = col - 1; c <= col + 1; c++)
+                        if (onBoard(r, c))
+                            damage(r, c, 10, 40);
+                return;
+
+            case hammer:
+                if (std::abs(dr) > 1 || std::abs(dc) > 1 || (dr == 0 && dc == 0))
+                    return;
+                if (onBoard(row, col))
+                    damage(row, col, 50, 60);
+                return;
+        }
+    }
+
+    void move(int index, int direction, int distance)
+    {
+        RobotBase* robot = mRobots[index];
+        if (robot->get_health() <= 0 || robot->get_move_speed() <= 0)
+            return;
+        int r, c;
+        robot->get_current_location(r, c);
+
+        for (int step = 0; step < distance; step++)
+        {
+            int nr = r + directions[direction].first;
+            int nc = c + directions[direction].second;
+            if (!onBoard(nr, nc))
+                return;
+            char type = cell(nr, nc).type;
+
+            if (type == 'M')
+                return;
+            if (type == 'P')
+            {
+                vacate(r, c);
+                occupy(nr, nc, 'R', index);
+                robot->move_to(nr, nc);
+                robot->disable_movement();
+                return;
+            }
+            if (type == 'F')
+            {
+                robot->take_damage(mRng.range(30, 50));
+                if (robot->get_health() <= 0)
+                {
+                    robot->disable_movement();
+                    vacate(r, c);
+                    occupy(nr, nc, 'X', index);
+                    robot->move_to(nr, nc);
+                    return;
+                }
+            }
+            if (type == 'R' || type == 'X')
+                return;
+
+            vacate(r, c);
+            occupy(nr, nc, 'R', index);
+            r = nr;
+            c = nc;
+            robot->move_to(r, c);
+        }
+    }
+
+    void iterate()
+    {
+        int count = static_cast<int>(mRobots.size());
+        std::vector<std::vector<RadarObj>> scans(count);
+        if (mSimultaneous)
+        {
+            for (int index = 0; index < count; index++)
+            {
+                if (mRobots[index]->get_health() <= 0)
+                    continue;
+                int direction = 0;
+                mRobots[index]->get_radar_direction(direction);
+                radar(index, direction, scans[index]);
+            }
+        }
+
+        for (int index = 0; index < count; index++)
+        {
+            RobotBase* robot = mRobots[index];
+            if (robot->get_health() <= 0)
+                continue;
+
+            if (!mSimultaneous)
+            {
+                int direction = 0;
+                robot->get_radar_direction(direction);
+                radar(index, direction, scans[index]);
+            }
+            robot->process_radar_results(scans[index]);
+
+            int row = 0;
+            int col = 0;
+            if (robot->get_shot_location(row, col))
+            {
+                shot(index, robot->get_weapon(), row, col);
+            }
+            else
+            {
+                int direction = 0;
+                int distance = 0;
+                robot->get_move_direction(direction, distance);
+                move(index, direction, distance);
+            }
+        }
+    }
+
+    int alive() const
+    {
+        int living = 0;
+        for (RobotBase* robot : mRobots)
+            living += robot->get_health() > 0;
+        return living;
+    }
+
+private:
+    bool onBoard(int r, int c) const { return r >= 0 && r < mHeight && c >= 0 && c < mWidth; }
+
+    void see(int r, int c, std::vector<RadarObj>& results) const
+    {
+        if (onBoard(r, c) && cell(r, c).type != '.')
+            results.emplace_back(cell(r, c).type, r, c);
+    }
+
+    // Step k of a shot along (dr, dc): one cell along the longer axis,
+    // round(k * minor / major) along the other, halves away from the shooter.
+    static int across(int major, int minor, int step)
+    {
+        return static_cast<int>((2LL * step * minor + major) / (2LL * major));
+    }
+    static int lineRow(int dr, int dc, int step)
+    {
+        int sign = (dr > 0) - (dr < 0);
+        if (std::abs(dr) >= std::abs(dc))
+            return sign * step;
+        return sign * across(std::abs(dc), std::abs(dr), step);
+    }
+    static int lineCol(int dr, int dc, int step)
+    {
+        int sign = (dc > 0) - (dc < 0);
+        if (std::abs(dc) > std::abs(dr))
+            return sign * step;
+        return sign * across(std::abs(dr), std::abs(dc), step);
+    }
+
+    void damage(int r, int c, int minDmg, int maxDmg)
+    {
+        Cell& target = mCells[r * mWidth + c];
+        if (target.type != 'R')
+            return;
+        RobotBase* robot = mRobots[target.robot];
+
+        int base = mRng.range(minDmg, maxDmg);
+        double factor = std::max(0.0, 1.0 - robot->get_armor() * 0.10);
+        robot->take_damage(static_cast<int>(base * factor));
+        robot->reduce_armor(1);
+        if (robot->get_health() <= 0)
+        {
+            robot->disable_movement();
+            target.type = 'X';
+        }
+    }
+
+    void occupy(int r, int c, char type, int index)
+    {
+        Cell& target = mCells[r * mWidth + c];
+        target.type = type;
+        target.robot = index;
+    }
+    void vacate(int r, int c)
+    {
+        Cell& target = mCells[r * mWidth + c];
+        target.type = target.terrain;
+        target.robot = -1;
+    }
+
+    int mHeight;
+    int mWidth;
+    std::vector<Cell> mCells;
+    std::vector<RobotBase*> mRobots;
+    ArenaRng mRng;
+    bool mSimultaneous;
+};
+
+// ---- RUNNING A CASE ON BOTH ----
+
+struct Outcome
+{
+    bool diverged = false;
+    int step = -1;   // action after which they differed, -1 = right after setup
+    std::string why;
+};
+
+// Both sides of one case, built from scratch.
+struct Pair
+{
+    std::vector<RobotBase*> realRobots;
+    std::vector<RobotBase*> modelRobots;
+    std::vector<std::string> tokens;
+    std::unique_ptr<ArenaUnderTest> real;
+    std::unique_ptr<ReferenceArena> model;
+
+    // the last snapshot of each side
+    bool saved = false;
+    ArenaSnapshot realSaved;
+    std::unique_ptr<ReferenceArena> modelSaved;
+    std::vector<ScriptedRobot> modelRobotsSaved;
+
+    explicit Pair(const Case& c)
+    {
+        tokens = sortedTokens(static_cast<int>(c.robots.size()));
+        std::map<std::string, RobotBase*> byToken;
+        for (size_t i = 0; i < c.robots.size(); i++)
+        {
+            realRobots.push_back(newRobot(c.robots[i], c.height, c.width));
+            modelRobots.push_back(newRobot(c.robots[i], c.height, c.width));
+            byToken[tokens[i]] = realRobots.back();
+        }
+        real = std::make_unique<ArenaUnderTest>(c.height, c.width, byToken, c.obstacles, c.seed,
+                                                c.pits, c.mounds, c.flames);
+        real->setSimultaneousRadar(c.simultaneous);
+        model = std::make_unique<ReferenceArena>(*real, modelRobots, c.simultaneous);
+    }
+    ~Pair()
+    {
+        real.reset();
+        for (RobotBase* robot : realRobots)
+            delete robot;
+        for (RobotBase* robot : modelRobots)
+            delete robot;
+    }
+    Pair(const Pair&) = delete;
+    Pair& operator=(const Pair&) = delete;
+};
+
+static std::string describeRadar(const std::vector<RadarObj>& results)
+{
+    std::string text;
+    for (const RadarObj& object : results)
+        text += std::string(1, object.m_type) + "(" + std::to_string(object.m_row) + "," +
+                std::to_string(object.m_col) + ") ";
+    return text.empty() ? "nothing" : text;
+}
+
+static bool sameRadar(const std::vector<RadarObj>& a, const std::vector<RadarObj>& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (a[i].m_type != b[i].m_type || a[i].m_row != b[i].m_row || a[i].m_col != b[i].m_col)
+            return false;
+    }
+    return true;
+}
+
+// Everything observable about an arena and the model; fills why on the
+// first difference. Radar results shown are only kept by ScriptedRobots.
+static bool agree(const Arena& real, const std::vector<RobotBase*>& realRobots, const ReferenceArena& model,
+                  const std::vector<RobotBase*>& modelRobots, const std::vector<std::string>& tokens,
+                  bool compareSeen, std::string& why)
+{
+    std::ostringstream out;
+
+    for (int row = 0; row < real.getHeight(); row++)
+    {
+        for (int col = 0; col < real.getWidth(); col++)
+        {
+            const Cell& a = real.getCell(row, col);
+            const Cell& b = model.cell(row, col);
+            if (a.type != b.type || a.terrain != b.terrain || a.robot != b.robot)
+            {
+                out << "cell (" << row << "," << col << ") is " << a.type << a.terrain << " robot "
+                    << a.robot << ", reference has " << b.type << b.terrain << " robot " << b.robot;
+                why = out.str();
+                return false;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < realRobots.size(); i++)
+    {
+        RobotBase* a = realRobots[i];
+        RobotBase* b = modelRobots[i];
+        int ar, ac, br, bc;
+        a->get_current_location(ar, ac);
+        b->get_current_location(br, bc);
+        if (a->get_health() != b->get_health() || a->get_armor() != b->get_armor() ||
+            a->get_move_speed() != b->get_move_speed() || a->get_grenades() != b->get_grenades() ||
+            ar != br || ac != bc)
+        {
+            out << tokens[i] << " is " << a->print_stats() << " at (" << ar << "," << ac
+                << "), reference has " << b->print_stats() << " at (" << br << "," << bc << ")";
+            why = out.str();
+            return false;
+        }
+        if (!compareSeen)
+            continue;
+        const std::vector<RadarObj>& aSeen = static_cast<ScriptedRobot*>(a)->seen;
+        const std::vector<RadarObj>& bSeen = static_cast<ScriptedRobot*>(b)->seen;
+        if (!sameRadar(aSeen, bSeen))
+        {
+            why = tokens[i] + " was shown " + describeRadar(aSeen) + ", reference " + describeRadar(bSeen);
+            return false;
+        }
+    }
+
+    int living = model.alive();
+    std::string winner = "none";
+    for (size_t i = 0; i < modelRobots.size() && living == 1; i++)
+        if (modelRobots[i]->get_health() > 0)
+            winner = tokens[i];
+    if (real.getAlive() != living || real.getWinner() != winner)
+    {
+        out << "getAlive() " << real.getAlive() << " getWinner() " << real.getWinner()
+            << ", reference has " << living << " alive, winner " << winner;
+        why = out.str();
+        return false;
+    }
+    return true;
+}
+
+static bool agree(const Pair& pair, std::string& why)
+{
+    return agree(*pair.real, pair.realRobots, *pair.model, pair.modelRobots, pair.tokens, true, why);
+}
+
+// Forks the arena and plays a shot on the fork and on a copy of the
+// model: the fork must match before and after, and the arena must not
+// notice.
+static bool checkFork(const Pair& pair, int index, int row, int col, std::string& why)
+{
+    std::unique_ptr<Arena> fork = pair.real->fork();
+    std::vector<RobotBase*> forkRobots;
+    for (int i = 0; i < fork->getRobotCount(); i++)
+        forkRobots.push_back(fork->getRobot(i));
+
+    std::vector<ScriptedRobot> copies;
+    for (RobotBase* robot : pair.modelRobots)
+        copies.push_back(*static_cast<ScriptedRobot*>(robot));
+    std::vector<RobotBase*> copyRobots;
+    for (ScriptedRobot& copy : copies)
+        copyRobots.push_back(&copy);
+    ReferenceArena whatIf = *pair.model;
+    whatIf.useRobots(copyRobots);
+
+    if (!agree(*fork, forkRobots, whatIf, copyRobots, pair.tokens, false, why))
+    {
+        why = "fork: " + why;
+        return false;
+    }
+    RobotBase* shooter = forkRobots[index];
+    if (shooter->get_health() > 0)
+    {
+        fork->handle_shot(shooter->get_weapon(), shooter, row, col);
+        whatIf.shot(index, shooter->get_weapon(), row, col);
+    }
+    if (!agree(*fork, forkRobots, whatIf, copyRobots, pair.tokens, false, why))
+    {
+        why = "fork after a shot: " + why;
+        return false;
+    }
+    return true;
+}
+
+static Outcome runCase(const Case& c)
+{
+    Outcome outcome;
+    Pair pair(c);
+    int count = static_cast<int>(c.robots.size());
+    std::vector<RadarObj> realRadar, modelRadar;
+
+    if (!agree(pair, outcome.why))
+    {
+        outcome.diverged = true;
+        return outcome;
+    }
+
+    for (size_t step = 0; step < c.actions.size(); step++)
+    {
+        const Action& action = c.actions[step];
+        int index = action.robot % count;
+        RobotBase* realRobot = pair.realRobots[index];
+
+        switch (action.kind)
+        {
+            case RadarAction:
+                pair.real->get_radar_results(realRobot, action.a, realRadar);
+                pair.model->radar(index, action.a, modelRadar);
+                if (!sameRadar(realRadar, modelRadar))
+                {
+                    outcome.why = "radar " + describeRadar(realRadar) + ", reference " + describeRadar(modelRadar);
+                    outcome.diverged = true;
+                }
+                break;
+
+            // the dead do not act, just as in iterate()
+            case ShotAction:
+                if (realRobot->get_health() > 0)
+                {
+                    pair.real->handle_shot(realRobot->get_weapon(), realRobot, action.a, action.b);
+                    pair.model->shot(index, realRobot->get_weapon(), action.a, action.b);
+                }
+                break;
+
+            case MoveAction:
+                if (realRobot->get_health() > 0)
+                {
+                    pair.real->handle_movement(index, realRobot, action.a, action.b);
+                    pair.model->move(index, action.a, action.b);
+                }
+                break;
+
+            case RoundAction:
+                pair.real->iterate();
+                pair.model->iterate();
+                break;
+
+            case SnapshotAction:
+                pair.real->snapshot(pair.realSaved);
+                pair.modelSaved = std::make_unique<ReferenceArena>(*pair.model);
+                pair.modelRobotsSaved.clear();
+                for (RobotBase* robot : pair.modelRobots)
+                    pair.modelRobotsSaved.push_back(*static_cast<ScriptedRobot*>(robot));
+                pair.saved = true;
+                break;
+
+            // robots keep their own memory; only RobotBase goes back
+            case RestoreAction:
+                if (pair.saved)
+                {
+                    pair.real->restore(pair.realSaved);
+                    *pair.model = *pair.modelSaved;
+                    for (size_t i = 0; i < pair.modelRobots.size(); i++)
+                        static_cast<RobotBase&>(*pair.modelRobots[i]) = pair.modelRobotsSaved[i];
+                }
+                break;
+
+            case ForkAction:
+                if (!checkFork(pair, index, action.a, action.b, outcome.why))
+                    outcome.diverged = true;
+                break;
+        }
+
+        if (outcome.diverged || !agree(pair, outcome.why))
+        {
+            outcome.diverged = true;
+            outcome.step = static_cast<int>(step);
+            return outcome;
+        }
+    }
+    return outcome;
+}
+
+// ---- RANDOM CASES ----
+
+static Case generateCase(std::uint64_t caseSeed)
+{
+    ArenaRng rng(caseSeed);
+    Case c;
+    c.seed = rng.next();
+    c.height = rng.range(2, 24);
+    c.width = rng.range(2, 24);
+    int interior = std::max(0, (c.height - 2) * (c.width - 2));
+
+    // anything from an open field to a packed board
+    int fill = rng.range(0, 3) * interior / 4;
+    c.obstacles = rng.range(0, fill);
+    c.pits = rng.range(0, fill - c.obstacles);
+    c.mounds = rng.range(0, fill - c.obstacles - c.pits);
+    c.flames = rng.range(0, fill - c.obstacles - c.pits - c.mounds);
+    c.simultaneous = rng.below(2) == 1;
+
+    int free = c.height * c.width - c.obstacles - c.pits - c.mounds - c.flames;
+    int robots = std::min(free, rng.below(4) == 0 ? rng.range(2, 26) : rng.range(2, 6));
+    for (int i = 0; i < robots; i++)
+    {
+        RobotSpec spec;
+        spec.move = rng.range(2, 5);
+        spec.armor = rng.range(0, 7 - spec.move);
+        spec.weapon = static_cast<WeaponType>(rng.below(4));
+        spec.script = static_cast<std::uint32_t>(rng.next());
+        c.robots.push_back(spec);
+    }
+
+    int actions = rng.range(1, 200);
+    for (int i = 0; i < actions; i++)
+    {
+        Action action;
+        // mostly play, now and then a snapshot, restore or fork
+        static const ActionKind kinds[] = {
+            RadarAction, RadarAction, RadarAction, RadarAction,
+            ShotAction, ShotAction, ShotAction, ShotAction, ShotAction,
+            MoveAction, MoveAction, MoveAction, MoveAction, MoveAction,
+            RoundAction, RoundAction, RoundAction,
+            SnapshotAction, RestoreAction, ForkAction
+        };
+        action.kind = kinds[rng.below(static_cast<int>(std::size(kinds)))];
+        action.robot = rng.below(robots);
+        switch (action.kind)
+        {
+            case RadarAction:
+                action.a = rng.range(0, 9);
+                action.b = 0;
+                break;
+            case ShotAction:
+            case ForkAction:
+                // off the board now and then, and the shooter's own cell
+                action.a = rng.range(-2, c.height + 1);
+                action.b = rng.range(-2, c.width + 1);
+                break;
+            case MoveAction:
+                action.a = rng.range(0, 8);
+                action.b = rng.range(0, 6);
+                break;
+            case RoundAction:
+            case SnapshotAction:
+            case RestoreAction:
+                action.a = 0;
+                action.b = 0;
+                break;
+        }
+        c.actions.push_back(action);
+    }
+    return c;
+}
+
+// ---- MINIMISING A DIVERGENCE ----
+
+// a copy of c that still diverges, cut back to the diverging action
+static bool stillDiverges(Case& c)
+{
+    Outcome outcome = runCase(c);
+    if (!outcome.diverged)
+        return false;
+    c.actions.resize(static_cast<size_t>(outcome.step + 1));
+    return true;
+}
+
+static Case minimise(Case c)
+{
+    stillDiverges(c);
+
+    bool shrunk = true;
+    while (shrunk)
+    {
+        shrunk = false;
+
+        // drop runs of actions, halving the run length
+        for (size_t chunk = std::max<size_t>(c.actions.size() / 2, 1); chunk >= 1; chunk /= 2)
+        {
+            for (size_t start = 0; start < c.actions.size(); )
+            {
+                Case trial = c;
+                trial.actions.erase(trial.actions.begin() + start,
+                                    trial.actions.begin() + std::min(start + chunk, trial.actions.size()));
+                if (stillDiverges(trial))
+                {
+                    c = trial;
+                    shrunk = true;
+                }
+                else
+                {
+                    start += chunk;
+                }
+            }
+        }
+
+        // fewer robots, fewer obstacles, a smaller board
+        auto attempt = [&](auto change)
+        {
+            Case trial = c;
+            if (!change(trial))
+                return;
+            int free = trial.height * trial.width - trial.obstacles - trial.pits - trial.mounds - trial.flames;
+            int interior = std::max(0, (trial.height - 2) * (trial.width - 2));
+            if (trial.robots.empty() || static_cast<int>(trial.robots.size()) > free ||
+                trial.obstacles + trial.pits + trial.mounds + trial.flames > interior)
+                return;
+            if (stillDiverges(trial))
+            {
+                c = trial;
+                shrunk = true;
+            }
+        };
+        attempt([](Case& t) { if (t.robots.size() < 2) return false; t.robots.pop_back(); return true; });
+        attempt([](Case& t) { if (t.robots.size() < 2) return false; t.robots.erase(t.robots.begin()); return true; });
+        for (int Case::*count : {&Case::obstacles, &Case::pits, &Case::mounds, &Case::flames})
+        {
+            attempt([count](Case& t) { if (t.*count == 0) return false; t.*count = 0; return true; });
+            attempt([count](Case& t) { if (t.*count == 0) return false; t.*count /= 2; return true; });
+        }
+        attempt([](Case& t) { if (t.height <= 2) return false; t.height--; return true; });
+        attempt([](Case& t) { if (t.width <= 2) return false; t.width--; return true; });
+        attempt([](Case& t) { if (!t.simultaneous) return false; t.simultaneous = false; return true; });
+    }
+    return c;
+}
+
+static void printCase(const Case& c)
+{
+    std::vector<std::string> tokens = sortedTokens(static_cast<int>(c.robots.size()));
+    std::cout << "  arena " << c.height << "x" << c.width << ", seed " << c.seed << ", obstacles "
+              << c.obstacles << ", pits " << c.pits << ", mounds " << c.mounds << ", flames " << c.flames
+              << ", simultaneous radar " << (c.simultaneous ? "on" : "off") << "\n";
+    for (size_t i = 0; i < c.robots.size(); i++)
+    {
+        const RobotSpec& spec = c.robots[i];
+        std::cout << "  " << tokens[i] << ": move " << spec.move << ", armor " << spec.armor << ", "
+                  << kWeaponNames[spec.weapon] << ", script " << spec.script << "\n";
+    }
+
+    Pair pair(c);
+    std::cout << "  starting board:\n";
+    pair.real->printState(std::cout);
+
+    int count = static_cast<int>(c.robots.size());
+    for (size_t step = 0; step < c.actions.size(); step++)
+    {
+        const Action& action = c.actions[step];
+        const std::string& token = tokens[action.robot % count];
+        std::cout << "  " << step << ": ";
+        switch (action.kind)
+        {
+            case RadarAction:
+                std::cout << token << " radar " << action.a;
+                break;
+            case ShotAction:
+                std::cout << token << " shoots at (" << action.a << "," << action.b << ")";
+                break;
+            case MoveAction:
+                std::cout << token << " moves " << action.b << " in direction " << action.a;
+                break;
+            case RoundAction:
+                std::cout << "round";
+                break;
+            case SnapshotAction:
+                std::cout << "snapshot";
+                break;
+            case RestoreAction:
+                std::cout << "restore";
+                break;
+            case ForkAction:
+                std::cout << "fork, then " << token << " shoots at (" << action.a << "," << action.b << ")";
+                break;
+        }
+        std::cout << "\n";
+    }
+}
+
+// Runs one case; on a divergence prints it minimised and returns false.
+static bool checkCase(std::uint64_t caseSeed)
+{
+    Case c = generateCase(caseSeed);
+    Outcome outcome = runCase(c);
+    if (!outcome.diverged)
+        return true;
+
+    std::cout << "DIVERGENCE in case " << caseSeed << " after action " << outcome.step << " of "
+              << c.actions.size() << ": " << outcome.why << "\n";
+    Case small = minimise(c);
+    Outcome smallOutcome = runCase(small);
+    std::cout << "Minimised reproducer (" << small.actions.size() << " actions), diverging with: "
+              << smallOutcome.why << "\n";
+    printCase(small);
+    std::cout << "Rerun with: fuzz_arena --case " << caseSeed << "\n";
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    long long cases = 1000;
+    std::uint64_t seed = 1;
+    bool single = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--cases" && i + 1 < argc)
+            cases = std::atoll(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--case" && i + 1 < argc)
+        {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+            single = true;
+        }
+        else
+        {
+            std::cerr << "usage: fuzz_arena [--cases N] [--seed S] | --case S\n";
+            return 2;
+        }
+    }
+
+    if (single)
+        cases = 1;
+    for (long long n = 0; n < cases; n++)
+    {
+        if (!checkCase(seed + n))
+            return 1;
+    }
+    std::cout << "No divergence in " << cases << " cases from seed " << seed << "\n";
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include "RobotWarz_aux.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Tests for game settings: single options, config files, the limits
+// checked before a game and how the command line layers over a config.
+
+static int failures = 0;
+
+static void check(const std::string& test_name, bool condition)
+{
+    std::cout << (condition ? "[PASS] " : "[FAIL] ") << test_name << "\n";
+    if (!condition)
+        failures++;
+}
+
+static std::string writeConfig(const std::string& name, const std::string& text)
+{
+    std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream(path) << text;
+    return path;
+}
+
+// argv as main gets it, program name first
+static bool parse(std::vector<std::string> args, CommandLine& command, std::string& error)
+{
+    args.insert(args.begin(), "RobotWarz");
+    std::vector<char*> argv;
+    for (std::string& arg : args)
+        argv.push_back(arg.data());
+    return parseCommandLine(static_cast<int>(argv.size()), argv.data(), command, error);
+}
+
+void test_game_options()
+{
+    GameSetup setup = defaultGameSetup();
+    std::string error;
+
+    check("an integer setting is applied",
+          applyGameOption(setup, "height", "25", error) && setup.height == 25);
+    check("a malformed integer is rejected and leaves the setting alone",
+          !applyGameOption(setup, "height", "25x", error) && setup.height == 25 &&
+              error.find("height") != std::string::npos);
+    check("an empty integer is rejected", !applyGameOption(setup, "width", "", error));
+    check("an integer out of range is rejected",
+          !applyGameOption(setup, "max_rounds", "99999999999", error));
+
+    check("yes/no settings take y and n",
+          applyGameOption(setup, "watch_live", "y", error) && setup.watchLive &&
+              applyGameOption(setup, "watch_live", "n", error) && !setup.watchLive);
+    check("a yes/no setting rejects anything else",
+          !applyGameOption(setup, "simultaneous_radar", "maybe", error));
+
+    check("profile takes cycles", applyGameOption(setup, "profile", "cycles", error) && setup.profile == 2);
+    check("profile rejects other words", !applyGameOption(setup, "profile", "fast", error));
+
+    check("a seed is applied", applyGameOption(setup, "seed", "42", error) && setup.seed == 42);
+    check("a negative seed is rejected",
+          !applyGameOption(setup, "seed", "-1", error) && setup.seed == 42);
+    check("a malformed seed is rejected", !applyGameOption(setup, "seed", "4 2", error));
+
+    check("an unknown setting is rejected by name",
+          !applyGameOption(setup, "colour", "red", error) && error.find("colour") != std::string::npos);
+}
+
+void test_config_file()
+{
+    std::string error;
+
+    GameSetup setup = defaultGameSetup();
+    std::string path = writeConfig("test_config_good.cfg",
+                                   "# a comment\n"
+                                   "\n"
+                                   "height = 30   # trailing comment\n"
+                                   "  width=24\n"
+                                   "robot_dir = some dir\n");
+    check("a config file is read, comments and blank lines skipped",
+          loadGameConfig(path, setup, error) && setup.height == 30 && setup.width == 24 &&
+              setup.robotDirectory == "some dir");
+
+    path = writeConfig("test_config_value.cfg", "height = 30\n\nwidth = wide\n");
+    check("a bad value names the file and line",
+          !loadGameConfig(path, setup, error) && error.find("test_config_value.cfg:3:") != std::string::npos);
+
+    path = writeConfig("test_config_key.cfg", "height 30\n");
+    check("a line without '=' is rejected", !loadGameConfig(path, setup, error));
+
+    path = writeConfig("test_config_unknown.cfg", "hieght = 30\n");
+    check("an unknown key in a file is rejected", !loadGameConfig(path, setup, error));
+    std::filesystem::remove(path);
+    check("a missing config file is an error", !loadGameConfig(path, setup, error));
+
+    for (const char* name : {"test_config_good.cfg", "test_config_value.cfg", "test_config_key.cfg"})
+        std::filesystem::remove(std::filesystem::temp_directory_path() / name);
+}
+
+void test_validate_setup()
+{
+    std::string error;
+
+    GameSetup setup = defaultGameSetup();
+    check("the default setup is valid", validateGameSetup(setup, error));
+
+    setup.width = 9;
+    check("a board under 10 x 10 is rejected", !validateGameSetup(setup, error));
+
+    setup = defaultGameSetup();
+    setup.numPits = -1;
+    check("negative obstacle counts are rejected", !validateGameSetup(setup, error));
+
+    // a 10 x 10 board has 64 cells inside the border
+    setup = defaultGameSetup();
+    setup.height = 10;
+    setup.width = 10;
+    setup.numObstacles = 60;
+    setup.numFlames = 4;
+    check("obstacles filling the interior are allowed", validateGameSetup(setup, error));
+    setup.numFlames = 5;
+    check("more obstacles than the interior holds are rejected", !validateGameSetup(setup, error));
+
+    setup = defaultGameSetup();
+    setup.deadlineMicros = -5;
+    check("a negative deadline is rejected", !validateGameSetup(setup, error));
+}
+
+void test_command_line()
+{
+    std::string error;
+    std::string path = writeConfig("test_config_layer.cfg", "height = 30\nwidth = 24\nmax_rounds = 50\n");
+
+    // the config is read first wherever it appears, then the settings
+    CommandLine command;
+    bool ok = parse({"--height", "40", "--config", path, "--max-rounds", "7"}, command, error);
+    const GameSetup& game = command.tournament.game;
+    check("command-line settings override the config file, before or after it",
+          ok && game.height == 40 && game.width == 24 && game.maxRounds == 7 && command.configured);
+
+    command = CommandLine();
+    check("tournament and threads are read",
+          parse({"--tournament", "5", "--threads", "0"}, command, error) &&
+              command.tournament.numGames == 5 && command.tournament.numThreads == 0 && !command.configured);
+
+    command = CommandLine();
+    check("negative --threads is rejected", !parse({"--threads", "-1"}, command, error));
+    command = CommandLine();
+    check("malformed --tournament is rejected", !parse({"--tournament", "3x"}, command, error));
+    command = CommandLine();
+    check("--round must be positive", !parse({"--replay", "a.rwz", "--round", "0"}, command, error));
+
+    command = CommandLine();
+    check("a bad setting shows the usage",
+          !parse({"--height", "tall"}, command, error) && command.showUsage && !error.empty());
+    command = CommandLine();
+    check("a stray argument shows the usage",
+          !parse({"stray"}, command, error) && command.showUsage);
+
+    command = CommandLine();
+    check("a bad config file stops the parse",
+          !parse({"--config", path + ".missing"}, command, error) && !command.showUsage);
+
+    std::filesystem::remove(path);
+}
+
+int main()
+{
+    std::cout << "\n=== Testing Game Settings ===\n";
+    test_game_options();
+    test_config_file();
+    test_validate_setup();
+    test_command_line();
+
+    std::cout << "\n" << (failures == 0 ? "All config tests passed" : "Some config tests FAILED")
+              << "\n";
+    return failures == 0 ? 0 : 1;
+}
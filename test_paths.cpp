@@ -0,0 +1,493 @@
+#include "Arena.h"
+#include "LineTrace.h"
+#include "ReplayLog.h"
+#include "RobotToken.h"
+#include "ScriptedRobot.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Regression tests for the integer railgun and flamethrower paths,
+// the precomputed weapon footprints, item placement, replay logs and
+// callback deadlines.
+
+typedef std::vector<std::pair<int, int>> Path;
+
+static int failures = 0;
+
+static void check(const std::string& test_name, bool condition)
+{
+    std::cout << (condition ? "[PASS] " : "[FAIL] ") << test_name << "\n";
+    if (!condition)
+        failures++;
+}
+
+static std::string describe(const Path& path)
+{
+    std::string text;
+    for (const auto& [r, c] : path)
+        text += "(" + std::to_string(r) + "," + std::to_string(c) + ") ";
+    return text;
+}
+
+// the example path from RobotWarz_spec.md
+void test_spec_example()
+{
+    Arena arena(8, 10, {}, 0);
+    Path path = arena.railgunPath(2, 2, 4, 5);
+    Path expected = {{3, 3}, {3, 4}, {4, 5}, {5, 6}, {5, 7}, {6, 8}, {7, 9}};
+
+    if (path != expected)
+        std::cout << "  got " << describe(path) << "\n";
+    check("railgun (2,2)->(4,5) matches the spec", path == expected);
+
+    // on a bigger board the same line keeps going to the edge
+    Arena wide(20, 20, {}, 0);
+    Path longer = wide.railgunPath(2, 2, 4, 5);
+    bool prefix = longer.size() > expected.size() &&
+                  Path(longer.begin(), longer.begin() + expected.size()) == expected;
+    check("railgun continues past the target to the edge", prefix);
+    check("railgun stops on the last column",
+          !longer.empty() && longer.back().second == 19);
+}
+
+void test_straight_lines()
+{
+    Arena arena(12, 15, {}, 0);
+    bool ok = true;
+    for (int d = 1; d <= 8; d++)
+    {
+        int dr = directions[d].first;
+        int dc = directions[d].second;
+        Path expected;
+        for (int r = 6 + dr, c = 7 + dc; r >= 0 && r < 12 && c >= 0 && c < 15; r += dr, c += dc)
+            expected.push_back({r, c});
+
+        ok = ok && arena.railgunPath(6, 7, 6 + 3 * dr, 7 + 3 * dc) == expected;
+    }
+    check("railgun along rows, columns and diagonals", ok);
+}
+
+void test_every_cell_once()
+{
+    Arena arena(30, 40, {}, 0);
+    const int origins[][2] = {{0, 0}, {15, 20}, {29, 39}, {3, 37}, {28, 1}};
+    bool unique = true;
+    bool connected = true;
+    bool reachesEdge = true;
+    bool skipsShooter = true;
+
+    for (const auto& origin : origins)
+    {
+        int sx = origin[0];
+        int sy = origin[1];
+        for (int dr = -20; dr <= 20; dr++)
+        {
+            for (int dc = -20; dc <= 20; dc++)
+            {
+                if (dr == 0 && dc == 0)
+                    continue;
+
+                Path path = arena.railgunPath(sx, sy, sx + dr, sy + dc);
+                std::set<std::pair<int, int>> seen(path.begin(), path.end());
+                unique = unique && seen.size() == path.size();
+                skipsShooter = skipsShooter && !seen.count({sx, sy});
+
+                int pr = sx;
+                int pc = sy;
+                for (const auto& [r, c] : path)
+                {
+                    connected = connected && std::abs(r - pr) <= 1 && std::abs(c - pc) <= 1;
+                    pr = r;
+                    pc = c;
+                }
+
+                // the next cell along the line must be off the board
+                if (!path.empty())
+                {
+                    const auto& [r, c] = path.back();
+                    bool onEdge = r == 0 || r == 29 || c == 0 || c == 39;
+                    reachesEdge = reachesEdge && onEdge;
+                }
+            }
+        }
+    }
+
+    check("railgun visits each cell once", unique);
+    check("railgun never hits the shooter's cell", skipsShooter);
+    check("railgun cells are adjacent", connected);
+    check("railgun runs to the edge", reachesEdge);
+}
+
+void test_zero_vector()
+{
+    Arena arena(10, 10, {}, 0);
+    check("railgun at own cell does nothing", arena.railgunPath(4, 4, 4, 4).empty());
+    check("flamethrower at own cell does nothing", arena.flamePath(4, 4, 4, 4).empty());
+}
+
+void test_flame_footprint()
+{
+    Arena arena(30, 30, {}, 0);
+
+    Path right = arena.flamePath(5, 5, 5, 9);
+    Path expectedRight = {{6, 6}, {5, 6}, {4, 6},
+                          {6, 7}, {5, 7}, {4, 7},
+                          {6, 8}, {5, 8}, {4, 8},
+                          {6, 9}, {5, 9}, {4, 9}};
+    if (right != expectedRight)
+        std::cout << "  got " << describe(right) << "\n";
+    check("flamethrower to the right is 4 long and 3 wide", right == expectedRight);
+
+    bool ok = true;
+    for (int dr = -12; dr <= 12; dr++)
+    {
+        for (int dc = -12; dc <= 12; dc++)
+        {
+            if (dr == 0 && dc == 0)
+                continue;
+
+            Path path = arena.flamePath(15, 15, 15 + dr, 15 + dc);
+            std::set<std::pair<int, int>> seen(path.begin(), path.end());
+            ok = ok && path.size() == 12 && seen.size() == 12 && !seen.count({15, 15});
+            for (const auto& [r, c] : path)
+                ok = ok && std::abs(r - 15) <= 5 && std::abs(c - 15) <= 5;
+        }
+    }
+    check("flamethrower hits 12 distinct cells near the shooter", ok);
+
+    Path corner = arena.flamePath(0, 0, -5, -5);
+    check("flamethrower aimed off the board is clipped", corner.empty());
+}
+
+void test_flame_table()
+{
+    // every slope shares a precomputed footprint; it must match tracing
+    // the shot directly, including the bucket edges at long range
+    bool ok = true;
+    for (int dr = -60; dr <= 60; dr++)
+    {
+        for (int dc = -60; dc <= 60; dc++)
+        {
+            const Offset* cells = flameFootprint(dr, dc);
+            LineTrace trace(dr, dc);
+            if (trace.empty())
+            {
+                ok = ok && cells == nullptr;
+                continue;
+            }
+
+            int i = 0;
+            for (int step = 1; step <= 4 && cells; step++)
+            {
+                for (int w = -1; w <= 1; w++, i++)
+                {
+                    ok = ok && cells[i].dr == trace.rowOffset(step) + trace.perpRow() * w &&
+                         cells[i].dc == trace.colOffset(step) + trace.perpCol() * w;
+                }
+            }
+            ok = ok && cells != nullptr;
+        }
+    }
+    check("flame footprint table matches a traced shot", ok);
+
+    Path grenade = Arena(5, 5, {}, 0).grenadeRadius(0, 0);
+    check("grenade at a corner is clipped to 4 cells", grenade.size() == 4);
+}
+
+// how many cells of each type, and whether any item is on the border
+static std::map<char, int> countCells(const Arena& arena, bool& onBorder)
+{
+    std::map<char, int> counts;
+    onBorder = false;
+    for (int row = 0; row < arena.getHeight(); row++)
+    {
+        for (int col = 0; col < arena.getWidth(); col++)
+        {
+            char type = arena.getCell(row, col).type;
+            counts[type]++;
+            bool border = row == 0 || col == 0 || row == arena.getHeight() - 1 || col == arena.getWidth() - 1;
+            onBorder = onBorder || (border && type != '.');
+        }
+    }
+    return counts;
+}
+
+void test_item_placement()
+{
+    // a 10x10 board has 64 cells inside the border; fill every one
+    Arena full(10, 10, {}, 0, 3, 20, 24, 20);
+    bool onBorder;
+    std::map<char, int> counts = countCells(full, onBorder);
+    check("a full interior gets exactly the pits, mounds and flames asked for",
+          counts['P'] == 20 && counts['M'] == 24 && counts['F'] == 20 && !onBorder);
+
+    // random obstacles come on top of the exact per-type counts
+    Arena mixed(10, 10, {}, 30, 4, 5, 6, 7);
+    counts = countCells(mixed, onBorder);
+    check("random obstacles add to the per-type counts",
+          counts['P'] + counts['M'] + counts['F'] == 48 && counts['P'] >= 5 && counts['M'] >= 6 &&
+              counts['F'] >= 7 && !onBorder);
+
+    bool threw = false;
+    try
+    {
+        Arena overfull(10, 10, {}, 60, 1, 5, 0, 0);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    check("more obstacles than interior cells is an error", threw);
+}
+
+static bool sameCells(const std::vector<Cell>& a, const std::vector<Cell>& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (a[i].type != b[i].type || a[i].terrain != b[i].terrain || a[i].robot != b[i].robot)
+            return false;
+    }
+    return true;
+}
+
+static std::vector<int> healthOf(const std::vector<ReplayRobot>& robots)
+{
+    std::vector<int> health;
+    for (const ReplayRobot& robot : robots)
+        health.push_back(robot.health);
+    return health;
+}
+
+static std::string tempPath(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void test_replay_seek()
+{
+    // record a scripted game, keeping the board at the start of each round
+    const int rounds = 60;
+    const int size = 12;
+    std::string path = tempPath("test_paths_seek.rwz");
+
+    std::map<std::string, RobotBase*> robots;
+    for (int i = 0; i < 6; i++)
+    {
+        std::string token = robotToken(i);
+        RobotBase* robot = new ScriptedRobot(2 + i % 3, 2, static_cast<WeaponType>(i % 4),
+                                             1000 + i, size, size, false);
+        robot->m_character = token[1];
+        robots[token] = robot;
+    }
+
+    std::vector<std::vector<Cell>> boards(rounds + 1);
+    std::vector<std::vector<int>> health(rounds + 1);
+    {
+        Arena arena(size, size, robots, 20, 42);
+        check("replay file can be created", arena.startReplay(path));
+        for (int round = 1; round <= rounds; round++)
+        {
+            for (int row = 0; row < size; row++)
+                for (int col = 0; col < size; col++)
+                    boards[round].push_back(arena.getCell(row, col));
+            for (const auto& [token, robot] : robots)
+                health[round].push_back(robot->get_health());
+            arena.iterate();
+        }
+    }   // the arena finishes the log
+
+    ReplayReader forward;
+    std::string error;
+    check("recorded replay opens", forward.open(path, error));
+    check("replay knows how many rounds were played", forward.rounds() == rounds);
+
+    // playing forward shows each round as it was recorded
+    bool ok = true;
+    int seen = 0;
+    ReplayRecord record;
+    while (forward.next(record))
+    {
+        if (record.kind != ReplayRound)
+            continue;
+        seen++;
+        ok = ok && record.x == seen && sameCells(forward.cells(), boards[seen]) &&
+             healthOf(forward.robots()) == health[seen];
+    }
+    check("playing a replay forward matches the game", ok && seen == rounds);
+
+    // seek(n) lands on the same board, backwards and then forwards
+    ReplayReader seeker;
+    seeker.open(path, error);
+    ok = true;
+    for (int round = rounds; round >= 1; round--)
+    {
+        seeker.seek(round);
+        ok = ok && seeker.round() == round && sameCells(seeker.cells(), boards[round]) &&
+             healthOf(seeker.robots()) == health[round];
+    }
+    for (int round = 1; round <= rounds; round += 7)
+    {
+        seeker.seek(round);
+        ok = ok && seeker.round() == round && sameCells(seeker.cells(), boards[round]) &&
+             healthOf(seeker.robots()) == health[round];
+    }
+    check("seek(n) matches playing forward to round n", ok && !seeker.corrupt());
+
+    for (const auto& [token, robot] : robots)
+        delete robot;
+    std::filesystem::remove(path);
+}
+
+void test_replay_unknown_robot()
+{
+    // a 3x3 board with two robots; robot 2 does not exist
+    std::vector<std::string> ids = {"R@", "R#"};
+    std::vector<std::string> names = {"A", "B"};
+    std::vector<int> health = {100, 100};
+    std::vector<Cell> cells(9, Cell{'.', '.', -1});
+    std::string path = tempPath("test_paths_unknown.rwz");
+    std::string error;
+
+    cells[4] = Cell{'R', '.', 2};
+    {
+        ReplayWriter writer;
+        writer.open(path);
+        writer.writeHeader(1, 3, 3, ids, names, health, cells);
+        writer.close(0);
+    }
+    ReplayReader badBoard;
+    check("replay with an unknown robot on the board is rejected", !badBoard.open(path, error));
+
+    cells[4] = Cell{'R', '.', 1};
+    {
+        ReplayWriter writer;
+        writer.open(path);
+        writer.writeHeader(1, 3, 3, ids, names, health, cells);
+        writer.event(ReplayCell, 'X', 7, 1, 1);
+        writer.close(0);
+    }
+    ReplayReader badEvent;
+    ReplayRecord record;
+    bool opened = badEvent.open(path, error);
+    check("replay with an unknown robot in an event stops there",
+          opened && !badEvent.next(record) && badEvent.corrupt() && badEvent.cells()[4].robot == 1);
+
+    std::filesystem::remove(path);
+}
+
+void test_replay_write_limits()
+{
+    // every write to /dev/full fails as on a full disk
+    if (std::filesystem::exists("/dev/full"))
+    {
+        std::vector<Cell> cells(100 * 100, Cell{'.', '.', -1});
+        ReplayWriter writer;
+        bool opened = writer.open("/dev/full");
+        writer.writeHeader(1, 100, 100, {}, {}, {}, cells);
+        for (int i = 0; i < 10000; i++)
+            writer.event(ReplayRound, 0, -1, i, 0);
+        check("a replay that could not be written fails to close", opened && !writer.close(10000));
+    }
+
+    // one more robot than the u16 index can name
+    std::vector<ScriptedRobot> many(kReplayMaxRobots + 1, ScriptedRobot(1, 0, hammer, 1, 300, 300, false));
+    std::map<std::string, RobotBase*> robots;
+    for (size_t i = 0; i < many.size(); i++)
+        robots[robotToken(static_cast<int>(i))] = &many[i];
+    Arena crowded(300, 300, robots, 0, 1);
+    std::string path = tempPath("test_paths_crowded.rwz");
+    check("a replay refuses more robots than it can name", !crowded.startReplay(path));
+    check("an arena without a replay finishes cleanly", crowded.finishReplay());
+    std::filesystem::remove(path);
+}
+
+// Takes far longer than any deadline to pick a radar direction.
+class SlowRobot : public ScriptedRobot
+{
+public:
+    SlowRobot() : ScriptedRobot(2, 2, railgun, 7, 8, 8, false) {}
+    void get_radar_direction(int& radar_direction) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        ScriptedRobot::get_radar_direction(radar_direction);
+    }
+};
+
+void test_callback_deadline()
+{
+    // the slow robot is "R#", index 0, so it takes the first turn of a round;
+    // it is never deleted, see below
+    SlowRobot* slow = new SlowRobot();
+    ScriptedRobot other(2, 2, railgun, 11, 8, 8, false);
+    slow->m_character = '#';
+    other.m_character = '@';
+    std::map<std::string, RobotBase*> robots = {{"R#", slow}, {"R@", &other}};
+
+    auto arena = std::make_unique<Arena>(8, 8, robots, 0, 5);
+    arena->setCallbackDeadline(1000);
+    int row, col;
+    slow->get_current_location(row, col);
+    int health = slow->get_health();
+
+    arena->iterate();
+    check("an overrunning call counts as an overrun", arena->getOverruns(0) == 1);
+    check("the robot stays busy after its turn is forfeited", arena->isRobotBusy(0));
+
+    // still busy: the turn is forfeited again without a second call
+    arena->iterate();
+    check("a busy robot is not called again", arena->getOverruns(0) == 1);
+    const Cell& cell = arena->getCell(row, col);
+    check("a busy robot keeps its cell", cell.type == 'R' && cell.robot == 0);
+
+    while (arena->isRobotBusy(0))
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    int nowRow, nowCol;
+    slow->get_current_location(nowRow, nowCol);
+    check("a busy robot is neither moved nor damaged",
+          nowRow == row && nowCol == col && slow->get_health() == health);
+
+    // overrun again, then end the game while the call is still running
+    arena->iterate();
+    check("the robot is busy when the game ends", arena->isRobotBusy(0));
+    std::vector<int> retired = arena->retireBusyRobots();
+    check("a robot stuck at the end is retired and loses",
+          retired == std::vector<int>{0} && arena->getAlive() == 1 && arena->getWinner() == "R@");
+
+    auto start = std::chrono::steady_clock::now();
+    arena.reset();
+    check("destroying the arena does not wait for a stuck robot",
+          std::chrono::steady_clock::now() - start < std::chrono::milliseconds(50));
+    // its thread may still be inside slow, so slow is leaked, as a game does
+}
+
+int main()
+{
+    std::cout << "\n=== Testing Shot Paths ===\n";
+    test_spec_example();
+    test_straight_lines();
+    test_every_cell_once();
+    test_zero_vector();
+    test_flame_footprint();
+    test_flame_table();
+    test_item_placement();
+    test_replay_seek();
+    test_replay_unknown_robot();
+    test_replay_write_limits();
+    test_callback_deadline();
+
+    std::cout << "\n" << (failures == 0 ? "All path tests passed" : "Some path tests FAILED")
+              << "\n";
+    return failures == 0 ? 0 : 1;
+}